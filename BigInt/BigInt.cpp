@@ -1,884 +1,3247 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <charconv>
 #include <cmath>
 #include <compare>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <numeric>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include "BigInt.h"
 
-static const BigInt &Zero()
+#if defined(BIGINT_CHUNK64) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define BIGINT_ADX_KERNELS
+#endif
+
+using Chunk = BigInt::Chunk;
+using DoubleChunk = BigIntDoubleChunk;
+constexpr auto ChunkBits = BigInt::ChunkBits;
+
+static thread_local std::pmr::memory_resource *scopeResource = nullptr;
+
+std::pmr::memory_resource *ChunkVec::defaultResource()
 {
-    static const BigInt val(0);
-    return val;
+    return scopeResource ? scopeResource : std::pmr::get_default_resource();
 }
 
-static const BigInt &One()
+BigIntResourceScope::BigIntResourceScope(std::pmr::memory_resource *res) : prev(scopeResource)
 {
-    static const BigInt val(1);
-    return val;
+    scopeResource = res;
 }
 
-static const BigInt &TenQuintillion()
+BigIntResourceScope::~BigIntResourceScope() { scopeResource = prev; }
+
+// Trivially destructible so it stays usable while other thread_local and
+// static objects are destroyed, PoolCleanup gives the buffers back instead.
+struct PoolState
 {
-    static const BigInt val(10'000'000'000'000'000'000u);
-    return val;
-}
+    static constexpr std::size_t NumClasses = 40;
 
-template <typename N, typename D>
-auto ceilDiv(const N n, const D d) { return n / d + (n % d ? 1 : 0); }
+    bool enabled;
+    std::size_t maxCachedBytes;
+    std::size_t cachedBytes;
+    std::array<Chunk *, NumClasses> heads;
+    BigIntPool::Stats stats;
+};
 
-static bool addChunk(std::vector<std::uint32_t> &chunks, std::size_t i, const std::uint32_t val)
+static thread_local PoolState pool{};
+
+struct PoolCleanup
 {
-    auto hasCarry = (chunks[i++] += val) < val;
-    while (hasCarry && i < chunks.size())
-    {
-        hasCarry = ++chunks[i++] == 0;
-    }
-    return hasCarry;
-}
+    ~PoolCleanup() { BigIntPool::disable(); }
+};
+
+static thread_local PoolCleanup poolCleanup;
 
-static bool subChunk(std::vector<std::uint32_t> &chunks, std::size_t i, const std::uint32_t val)
+static bool usesPool(const std::pmr::memory_resource *res)
 {
-    auto prev = chunks[i];
-    auto hasBorrow = (chunks[i++] -= val) > prev;
-    while (hasBorrow && i < chunks.size())
-    {
-        hasBorrow = --chunks[i++] == static_cast<std::uint32_t>(-1);
-    }
-    return hasBorrow;
+    return pool.enabled && res == std::pmr::new_delete_resource();
 }
 
-static void add(BigInt &acc, const BigInt &other)
+static Chunk *allocateChunks(std::pmr::memory_resource *res, std::size_t &n)
 {
-    acc.chunks.resize(std::max(acc.chunks.size(), other.chunks.size()) + 1);
-    for (std::size_t i = 0; i < other.chunks.size(); ++i)
+    if (usesPool(res))
     {
-        if (other.chunks[i])
-            addChunk(acc.chunks, i, other.chunks[i]);
+        n = std::bit_ceil(n);
+        // sizes past the top class go straight to the upstream resource
+        const auto cls = static_cast<std::size_t>(std::countr_zero(n));
+        if (cls >= pool.heads.size())
+            return static_cast<Chunk *>(res->allocate(n * sizeof(Chunk), alignof(Chunk)));
+        auto &head = pool.heads[cls];
+        if (head)
+        {
+            auto ptr = head;
+            std::memcpy(&head, ptr, sizeof(head));
+            pool.cachedBytes -= n * sizeof(Chunk);
+            ++pool.stats.hits;
+            return ptr;
+        }
+        ++pool.stats.misses;
     }
-    acc.normalize();
+    return static_cast<Chunk *>(res->allocate(n * sizeof(Chunk), alignof(Chunk)));
 }
 
-static void sub(BigInt &acc, const BigInt &other)
+static void deallocateChunks(std::pmr::memory_resource *res, Chunk *ptr, const std::size_t n)
 {
-    if (acc.chunks.size() < other.chunks.size())
-        acc.chunks.resize(other.chunks.size());
-    bool hasBorrow = false;
-    for (std::size_t i = 0; i < other.chunks.size(); ++i)
-    {
-        if (other.chunks[i] && subChunk(acc.chunks, i, other.chunks[i]))
-            hasBorrow = true;
-    }
-    if (hasBorrow)
+    if (usesPool(res))
     {
-        for (auto &chunk : acc.chunks)
+        const auto cls = static_cast<std::size_t>(std::countr_zero(n));
+        if (std::has_single_bit(n) && cls < pool.heads.size() && pool.cachedBytes + n * sizeof(Chunk) <= pool.maxCachedBytes)
         {
-            chunk = ~chunk;
+            auto &head = pool.heads[cls];
+            std::memcpy(ptr, &head, sizeof(head));
+            head = ptr;
+            pool.cachedBytes += n * sizeof(Chunk);
+            ++pool.stats.cached;
+            return;
         }
-        addChunk(acc.chunks, 0, 1);
-        acc.negate();
+        ++pool.stats.freed;
     }
-    acc.normalize();
+    res->deallocate(ptr, n * sizeof(Chunk), alignof(Chunk));
 }
 
-BigInt::BigInt() {}
+double BigIntPool::Stats::hitRate() const
+{
+    return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+}
 
-BigInt::BigInt(int num) : BigInt(static_cast<long long>(num)) {}
-BigInt::BigInt(long num) : BigInt(static_cast<long long>(num)) {}
-BigInt::BigInt(const long long num) : BigInt(static_cast<unsigned long long>(num))
+void BigIntPool::enable(const std::size_t maxCachedBytes)
 {
-    if (num < 0)
-    {
-        bool borrow = true;
-        for (auto &chunk : chunks)
-        {
-            if (borrow)
-                borrow = --chunk == static_cast<std::uint32_t>(-1);
-            chunk = ~chunk;
-        }
-        isNeg = true;
-        normalize();
-    }
+    // touching the thread_local makes sure its destructor runs on thread exit
+    static_cast<void>(poolCleanup);
+    pool.enabled = true;
+    pool.maxCachedBytes = maxCachedBytes;
 }
 
-BigInt::BigInt(unsigned num) : BigInt(static_cast<unsigned long long>(num)) {}
-BigInt::BigInt(unsigned long num) : BigInt(static_cast<unsigned long long>(num)) {}
-BigInt::BigInt(unsigned long long num)
+void BigIntPool::disable()
 {
-    chunks.reserve(2);
-    while (num)
-    {
-        chunks.push_back(static_cast<std::uint32_t>(num));
-        num >>= 32;
-    }
+    release();
+    pool.enabled = false;
 }
 
-template <typename T>
-void floatConvert(BigInt &big, T t)
+bool BigIntPool::enabled() { return pool.enabled; }
+
+void BigIntPool::release()
 {
-    if (!std::isnormal(t))
-        return;
-    int exp;
-    auto fr = std::frexp(std::trunc(t), &exp);
-    if (fr < 0.0)
-    {
-        fr = -fr;
-        big.isNeg = true;
-    }
-    big.chunks.resize(ceilDiv(exp, 32));
-    for (std::size_t i = big.chunks.size(); i--;)
+    for (std::size_t i = 0; i < pool.heads.size(); ++i)
     {
-        auto &chunk = big.chunks[i];
-        auto j = exp % 32;
-        if (j == 0)
-            j = 32;
-        while (j--)
+        while (pool.heads[i])
         {
-            chunk <<= 1;
-            if (fr >= 0.5)
-            {
-                chunk |= 0x1;
-                fr -= 0.5;
-                if (fr == 0.0)
-                {
-                    chunk <<= j;
-                    return;
-                }
-            }
-            fr *= 2.0;
-            --exp;
+            auto ptr = pool.heads[i];
+            std::memcpy(&pool.heads[i], ptr, sizeof(ptr));
+            std::pmr::new_delete_resource()->deallocate(ptr, (std::size_t{1} << i) * sizeof(Chunk), alignof(Chunk));
         }
     }
+    pool.cachedBytes = 0;
 }
 
-BigInt::BigInt(float num) { floatConvert(*this, num); }
-BigInt::BigInt(double num) { floatConvert(*this, num); }
-BigInt::BigInt(long double num) { floatConvert(*this, num); }
+BigIntPool::Stats BigIntPool::stats() { return pool.stats; }
+void BigIntPool::resetStats() { pool.stats = {}; }
 
-BigInt &BigInt::operator+=(const BigInt &other)
+// Header in front of the chunks of a shared buffer.
+struct SharedHeader
 {
-    if (this == &other)
-    {
-        auto rhsCopy = other;
-        return *this += rhsCopy;
-    }
-    if (isNeg == other.isNeg)
-        add(*this, other);
-    else
-        sub(*this, other);
-    return *this;
-}
+    std::atomic<std::size_t> refs;
+};
 
-BigInt &BigInt::operator+=(BigInt &&other)
+static constexpr std::size_t SharedHeaderSize = sizeof(SharedHeader);
+
+static SharedHeader &sharedHeader(const Chunk *ptr)
 {
-    if (other.chunks.capacity() > chunks.capacity())
-        std::swap(*this, other);
-    return *this += other;
+    return *reinterpret_cast<SharedHeader *>(reinterpret_cast<std::uintptr_t>(ptr) - SharedHeaderSize);
 }
 
-BigInt &BigInt::operator-=(const BigInt &other)
+ChunkVec::ChunkVec() noexcept : ChunkVec(defaultResource()) {}
+
+ChunkVec::ChunkVec(std::pmr::memory_resource *res) noexcept
+    : ptr(buf), sz(0), cap(InlineCapacity), res(res), shared(false) {}
+
+ChunkVec::ChunkVec(const Chunk *first, const Chunk *last) : ChunkVec()
 {
-    if (this == &other)
-        return *this = Zero();
-    if (isNeg != other.isNeg)
-        add(*this, other);
-    else
-        sub(*this, other);
-    return *this;
+    assign(first, last);
 }
 
-BigInt &BigInt::operator-=(BigInt &&other)
+ChunkVec::ChunkVec(const ChunkVec &other) : ChunkVec()
 {
-    if (other.chunks.capacity() > chunks.capacity())
+    if (other.shared && !other.isInline())
+        adopt(other);
+    else
     {
-        std::swap(*this, other);
-        negate();
-        return *this += other;
+        shared = other.shared;
+        assign(other.begin(), other.end());
     }
-    return *this -= other;
 }
 
-BigInt &BigInt::operator*=(const BigInt &other) { return *this = *this * other; }
-
-BigInt &BigInt::operator/=(const BigInt &other) { return *this = std::move(*this) / other; }
-BigInt &BigInt::operator/=(BigInt &&other) { return *this = std::move(*this) / std::move(other); }
-BigInt &BigInt::operator%=(const BigInt &other) { return *this = std::move(*this) % other; }
-BigInt &BigInt::operator%=(BigInt &&other) { return *this = std::move(*this) % std::move(other); }
-
-static void bitwiseNormalizeNeg(bool &borrow, std::uint32_t &n)
+ChunkVec::ChunkVec(ChunkVec &&other) noexcept : ChunkVec(other.res)
 {
-    if (borrow)
-        borrow = --n == static_cast<std::uint32_t>(-1);
-    n = ~n;
+    shared = other.shared;
+    if (other.isInline())
+        std::copy(other.begin(), other.end(), buf);
+    else
+    {
+        ptr = other.ptr;
+        cap = other.cap;
+        other.ptr = other.buf;
+        other.cap = InlineCapacity;
+    }
+    sz = other.sz;
+    other.sz = 0;
 }
 
-static void bitwise(BigInt &lhs, const BigInt &rhs, const std::function<void(std::uint32_t &, std::uint32_t)> &fn)
+ChunkVec &ChunkVec::operator=(const ChunkVec &other)
 {
-    std::uint32_t x = lhs.isNeg ? static_cast<std::uint32_t>(-1) : 0;
-    fn(x, rhs.isNeg ? static_cast<std::uint32_t>(-1) : 0);
-    bool resIsNeg = static_cast<bool>(x);
-    lhs.chunks.resize(std::max(lhs.chunks.size(), rhs.chunks.size()) + (resIsNeg ? 1 : 0));
-    bool lhsBorrow = true, rhsBorrow = true, resBorrow = true;
-    for (std::size_t i = 0; i < lhs.chunks.size(); ++i)
+    if (this == &other)
+        return *this;
+    if (other.shared && !other.isInline())
     {
-        auto &a = lhs.chunks[i];
-        if (lhs.isNeg)
-            bitwiseNormalizeNeg(lhsBorrow, a);
-        auto b = i < rhs.chunks.size() ? rhs.chunks[i] : 0;
-        if (rhs.isNeg)
-            bitwiseNormalizeNeg(rhsBorrow, b);
-        fn(a, b);
-        if (resIsNeg)
-            bitwiseNormalizeNeg(resBorrow, a);
+        if (ptr != other.ptr)
+        {
+            freeStorage();
+            adopt(other);
+        }
+        sz = other.sz;
     }
-    lhs.isNeg = resIsNeg;
-    lhs.normalize();
+    else
+        assign(other.begin(), other.end());
+    return *this;
 }
 
-BigInt &BigInt::operator&=(const BigInt &other)
+ChunkVec &ChunkVec::operator=(ChunkVec &&other) noexcept
 {
     if (this == &other)
         return *this;
-    bitwise(*this, other,
-            [](std::uint32_t &a, std::uint32_t b)
-            { a &= b; });
+    if (other.isInline() || (!other.shared && *res != *other.res))
+    {
+        // noexcept relies on no allocation being needed when the resources
+        // differ, which isn't guaranteed, same as std::pmr::vector
+        assign(other.begin(), other.end());
+        other.sz = 0;
+        return *this;
+    }
+    freeStorage();
+    ptr = other.ptr;
+    sz = other.sz;
+    cap = other.cap;
+    res = other.res;
+    shared = other.shared;
+    other.ptr = other.buf;
+    other.sz = 0;
+    other.cap = InlineCapacity;
     return *this;
 }
 
-BigInt &BigInt::operator&=(BigInt &&other)
+ChunkVec::~ChunkVec() { freeStorage(); }
+
+std::size_t ChunkVec::useCount() const
 {
-    if (other.chunks.capacity() > chunks.capacity())
-        std::swap(*this, other);
-    return *this &= other;
+    return shared && !isInline() ? sharedHeader(ptr).refs.load(std::memory_order_relaxed) : 1;
 }
 
-BigInt &BigInt::operator|=(const BigInt &other)
+bool ChunkVec::isUnique() const
 {
-    if (this == &other)
-        return *this;
-    bitwise(*this, other,
-            [](std::uint32_t &a, std::uint32_t b)
-            { a |= b; });
-    return *this;
+    return !shared || isInline() || sharedHeader(ptr).refs.load(std::memory_order_acquire) == 1;
 }
 
-BigInt &BigInt::operator|=(BigInt &&other)
+void ChunkVec::unshare()
 {
-    if (other.chunks.capacity() > chunks.capacity())
-        std::swap(*this, other);
-    return *this |= other;
+    if (!isUnique())
+        reallocate(cap);
 }
 
-BigInt &BigInt::operator^=(const BigInt &other)
+void ChunkVec::adopt(const ChunkVec &other)
 {
-    if (this == &other)
-        return *this = Zero();
-    bitwise(*this, other,
-            [](std::uint32_t &a, std::uint32_t b)
-            { a ^= b; });
-    return *this;
+    sharedHeader(other.ptr).refs.fetch_add(1, std::memory_order_relaxed);
+    ptr = other.ptr;
+    sz = other.sz;
+    cap = other.cap;
+    res = other.res;
+    shared = true;
 }
 
-BigInt &BigInt::operator^=(BigInt &&other)
+Chunk *ChunkVec::allocate(std::size_t &n)
 {
-    if (other.chunks.capacity() > chunks.capacity())
-        std::swap(*this, other);
-    return *this ^= other;
+    if (!shared)
+        return allocateChunks(res, n);
+    auto bytes = static_cast<std::byte *>(res->allocate(SharedHeaderSize + n * sizeof(Chunk), alignof(SharedHeader)));
+    new (bytes) SharedHeader{1};
+    return reinterpret_cast<Chunk *>(bytes + SharedHeaderSize);
 }
 
-BigInt &BigInt::operator<<=(const std::int64_t n)
+void ChunkVec::freeStorage()
 {
-    if (n < 0)
-        throw std::invalid_argument("BigInt operator<<= has negative shift");
-    if (n == 0)
-        return *this;
-    const std::size_t off = n / 32;
-    const auto s = n % 32;
-    chunks.resize(chunks.size() + ceilDiv(n, 32));
-    for (auto i = chunks.size(); i--;)
-    {
-        std::uint32_t x = 0;
-        if (i >= off)
-            x = chunks[i - off] << s;
-        if (s && i >= off + 1)
-            x |= chunks[i - (off + 1)] >> (32 - s);
-        chunks[i] = x;
+    if (isInline())
+        return;
+    if (!shared)
+    {
+        deallocateChunks(res, ptr, cap);
+        return;
+    }
+    auto &header = sharedHeader(ptr);
+    if (header.refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        header.~SharedHeader();
+        res->deallocate(&header, SharedHeaderSize + cap * sizeof(Chunk), alignof(SharedHeader));
     }
-    normalize();
-    return *this;
 }
 
-BigInt &BigInt::operator>>=(const std::int64_t n)
+void ChunkVec::reallocate(std::size_t n)
 {
-    if (n < 0)
-        throw std::invalid_argument("BigInt operator>>= has negative shift");
-    if (n == 0)
-        return *this;
-    if (static_cast<std::size_t>(n) >= chunks.size() * 32)
+    auto newPtr = n > InlineCapacity ? allocate(n) : buf;
+    if (newPtr == ptr)
+        return;
+    std::copy(ptr, ptr + std::min(sz, n), newPtr);
+    freeStorage();
+    ptr = newPtr;
+    cap = std::max(n, InlineCapacity);
+}
+
+void ChunkVec::assign(const Chunk *first, const Chunk *last)
+{
+    const auto n = static_cast<std::size_t>(last - first);
+    if (n > cap || !isUnique())
     {
-        chunks.clear();
-        if (isNeg)
-            chunks.push_back(1);
-        return *this;
+        sz = 0;
+        reallocate(n);
     }
-    if (isNeg)
-        subChunk(chunks, 0, 1);
-    const std::size_t off = n / 32;
-    const auto s = n % 32;
-    for (std::size_t i = 0; i < chunks.size(); ++i)
-    {
-        std::uint32_t x = 0;
-        if (i + off < chunks.size())
-            x = chunks[i + off] >> s;
-        if (s && i + off + 1 < chunks.size())
-            x |= chunks[i + off + 1] << (32 - s);
-        chunks[i] = x;
-    }
-    if (isNeg)
-        addChunk(chunks, 0, 1);
-    normalize();
-    return *this;
+    std::copy(first, last, ptr);
+    sz = n;
 }
 
-BigInt &BigInt::operator++() { return *this += One(); }
-BigInt &BigInt::operator--() { return *this -= One(); }
+void ChunkVec::reserve(const std::size_t n)
+{
+    if (n > cap)
+        reallocate(n);
+}
 
-BigInt BigInt::operator++(int)
+void ChunkVec::resize(const std::size_t n)
 {
-    auto res = *this;
-    ++*this;
-    return res;
+    if (n > cap)
+        reallocate(std::max(n, cap * 2));
+    else if (n > sz)
+        detach();
+    if (n > sz)
+        std::fill(ptr + sz, ptr + n, 0);
+    sz = n;
 }
 
-BigInt BigInt::operator--(int)
+void ChunkVec::resizeForOverwrite(const std::size_t n)
 {
-    auto res = *this;
-    --*this;
-    return res;
+    if (n > cap)
+        reallocate(std::max(n, cap * 2));
+    else if (n > sz)
+        detach();
+    sz = n;
 }
 
-BigInt BigInt::operator-() const &
+void ChunkVec::push_back(const Chunk val)
 {
-    auto res = *this;
-    res.negate();
-    return res;
+    if (sz == cap)
+        reallocate(cap * 2);
+    else
+        detach();
+    ptr[sz++] = val;
 }
 
-BigInt BigInt::operator-() &&
+void ChunkVec::shrink_to_fit()
 {
-    negate();
-    return std::move(*this);
+    if (!isInline() && (sz < cap || !isUnique()))
+        reallocate(sz);
 }
 
-BigInt BigInt::operator~() const &
+void ChunkVec::share()
 {
-    auto res = *this;
-    res.invert();
-    return res;
+    if (shared)
+        return;
+    if (isInline() || sz <= InlineCapacity)
+    {
+        reallocate(InlineCapacity);
+        shared = true;
+        return;
+    }
+    const auto old = ptr;
+    const auto oldCap = cap;
+    shared = true;
+    cap = sz;
+    ptr = allocate(cap);
+    std::copy(old, old + sz, ptr);
+    deallocateChunks(res, old, oldCap);
 }
 
-BigInt BigInt::operator~() &&
+bool operator==(const ChunkVec &lhs, const ChunkVec &rhs)
 {
-    invert();
-    return std::move(*this);
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-BigInt::operator bool() const { return chunks.size(); }
+BigIntView::BigIntView(const BigInt &big)
+    : chunks(big.chunks.data(), big.chunks.size()), offset(big.offset), isNeg(big.isNeg) {}
 
-void BigInt::negate()
+BigIntView BigIntView::slice(const std::size_t pos, const std::size_t count) const
 {
-    if (*this == Zero())
-        return;
-    isNeg = !isNeg;
+    const auto total = offset + chunks.size();
+    const auto first = std::max(pos, offset);
+    const auto last = pos < total ? pos + std::min(count, total - pos) : total;
+    if (first >= last)
+        return {};
+    BigIntView res(chunks.subspan(first - offset, last - first), isNeg, first - pos);
+    res.normalize();
+    return res;
 }
 
-void BigInt::normalize()
+void BigIntView::normalize()
 {
     while (chunks.size() && chunks.back() == 0)
     {
-        chunks.pop_back();
+        chunks = chunks.first(chunks.size() - 1);
     }
     if (chunks.size() == 0)
+    {
         isNeg = false;
+        offset = 0;
+    }
 }
 
-void BigInt::invert()
+static Chunk chunkAt(const BigIntView big, const std::size_t i)
 {
-    if (isNeg)
-        subChunk(chunks, 0, 1);
-    else
+    return i >= big.offset && i - big.offset < big.chunks.size() ? big.chunks[i - big.offset] : 0;
+}
+
+static constexpr auto Zero = 0_big;
+static constexpr auto One = 1_big;
+static constexpr auto TenQuintillion = 10'000'000'000'000'000'000_big;
+
+template <typename N, typename D>
+auto ceilDiv(const N n, const D d) { return n / d + (n % d ? 1 : 0); }
+
+static bool addChunk(ChunkVec &chunks, std::size_t i, const Chunk val)
+{
+    auto hasCarry = (chunks[i++] += val) < val;
+    while (hasCarry && i < chunks.size())
     {
-        chunks.resize(chunks.size() + 1);
-        addChunk(chunks, 0, 1);
+        hasCarry = ++chunks[i++] == 0;
     }
-    isNeg = !isNeg;
-    normalize();
+    return hasCarry;
 }
 
-std::int64_t BigInt::toInteger() const
+// With 32 bit chunks the carry is kept in the top half of a 64 bit sum, which
+// compiles to tighter loops than comparisons. That doesn't hold for __int128.
+static constexpr bool NativeDoubleChunk = sizeof(DoubleChunk) <= sizeof(std::uint64_t);
+
+static Chunk addNPortable(Chunk *r, const Chunk *a, const Chunk *b, const std::size_t n)
 {
-    std::int64_t res = 0;
-    bool borrow = true;
-    for (std::size_t i = 0; i < 2; ++i)
+    if constexpr (NativeDoubleChunk)
     {
-        auto chunk = i < chunks.size() ? chunks[i] : 0;
-        if (isNeg)
+        DoubleChunk sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
         {
-            if (borrow)
-                borrow = --chunk == static_cast<std::uint32_t>(-1);
-            chunk = ~chunk;
+            sum += static_cast<DoubleChunk>(a[i]) + b[i];
+            r[i] = static_cast<Chunk>(sum);
+            sum >>= ChunkBits;
         }
-        res |= static_cast<std::uint64_t>(chunk) << i * 32;
+        return static_cast<Chunk>(sum);
     }
-    return res;
+    Chunk carry = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Chunk x = a[i] + carry;
+        carry = x < carry;
+        r[i] = x + b[i];
+        carry += r[i] < x;
+    }
+    return carry;
 }
 
-template <typename T>
-T floatConvert(const BigInt &big)
+static Chunk subNPortable(Chunk *r, const Chunk *a, const Chunk *b, const std::size_t n, Chunk borrow)
 {
-    T res = 0.0;
-    const auto n = sizeof(T) / 4 + 1;
-    constexpr T chunkMag = 4294967296.0;
-    for (auto i = big.chunks.size(), j = n; i-- && j--;)
+    if constexpr (NativeDoubleChunk)
     {
-        res *= chunkMag;
-        res += big.chunks[i];
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const auto diff = static_cast<DoubleChunk>(a[i]) - b[i] - borrow;
+            r[i] = static_cast<Chunk>(diff);
+            borrow = static_cast<Chunk>(diff >> ChunkBits) & 1;
+        }
+        return borrow;
     }
-    if (big.chunks.size() > n)
-        res *= static_cast<T>(std::pow(chunkMag, big.chunks.size() - n));
-    if (big.isNeg)
-        res = -res;
-    return res;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Chunk x = a[i] - b[i];
+        const Chunk hasBorrow = a[i] < b[i];
+        r[i] = x - borrow;
+        borrow = hasBorrow | (x < borrow);
+    }
+    return borrow;
 }
 
-float BigInt::toFloat() const { return floatConvert<float>(*this); }
-double BigInt::toDouble() const { return floatConvert<double>(*this); }
-long double BigInt::toLongDouble() const { return floatConvert<long double>(*this); }
+// r += a * m, returns the carry out. a * m + r + carry always fits in a
+// DoubleChunk, so a row carries a single chunk and nothing ripples. Unrolled
+// by four so the multiplies of a group can issue before the carry reaches them.
+static Chunk addMul1Portable(Chunk *r, const Chunk *a, const std::size_t n, const Chunk m)
+{
+    Chunk carry = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const auto p0 = static_cast<DoubleChunk>(a[i]) * m + r[i];
+        const auto p1 = static_cast<DoubleChunk>(a[i + 1]) * m + r[i + 1];
+        const auto p2 = static_cast<DoubleChunk>(a[i + 2]) * m + r[i + 2];
+        const auto p3 = static_cast<DoubleChunk>(a[i + 3]) * m + r[i + 3];
+        const auto x0 = p0 + carry;
+        r[i] = static_cast<Chunk>(x0);
+        const auto x1 = p1 + static_cast<Chunk>(x0 >> ChunkBits);
+        r[i + 1] = static_cast<Chunk>(x1);
+        const auto x2 = p2 + static_cast<Chunk>(x1 >> ChunkBits);
+        r[i + 2] = static_cast<Chunk>(x2);
+        const auto x3 = p3 + static_cast<Chunk>(x2 >> ChunkBits);
+        r[i + 3] = static_cast<Chunk>(x3);
+        carry = static_cast<Chunk>(x3 >> ChunkBits);
+    }
+    for (; i < n; ++i)
+    {
+        const auto x = static_cast<DoubleChunk>(a[i]) * m + r[i] + carry;
+        r[i] = static_cast<Chunk>(x);
+        carry = static_cast<Chunk>(x >> ChunkBits);
+    }
+    return carry;
+}
+
+// r -= a * m, returns the borrow out
+static Chunk subMul1Portable(Chunk *r, const Chunk *a, const std::size_t n, const Chunk m)
+{
+    Chunk borrow = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const auto x = static_cast<DoubleChunk>(a[i]) * m + borrow;
+        const auto lo = static_cast<Chunk>(x);
+        borrow = static_cast<Chunk>(x >> ChunkBits) + (r[i] < lo);
+        r[i] -= lo;
+    }
+    return borrow;
+}
+
+struct ChunkKernels
+{
+    Chunk (*addN)(Chunk *r, const Chunk *a, const Chunk *b, std::size_t n);
+    Chunk (*subN)(Chunk *r, const Chunk *a, const Chunk *b, std::size_t n, Chunk borrow);
+    Chunk (*addMul1)(Chunk *r, const Chunk *a, std::size_t n, Chunk m);
+    Chunk (*subMul1)(Chunk *r, const Chunk *a, std::size_t n, Chunk m);
+};
+
+static constexpr ChunkKernels PortableKernels{addNPortable, subNPortable, addMul1Portable, subMul1Portable};
+
+#ifdef BIGINT_ADX_KERNELS
+// BMI2 mulx plus adcx path. The carry chains go through _addcarryx_u64, which
+// GCC and Clang lower to a single adc/adcx chain, so the multiply accumulate
+// kernels keep their product and sum carries in registers between steps
+// rather than on separate adcx and adox flag chains. mulx leaves the flags
+// alone, which is what lets the product words feed the chain directly.
+using LongChunk = unsigned long long;
+
+__attribute__((target("adx"))) static Chunk addNAdx(Chunk *r, const Chunk *a, const Chunk *b, const std::size_t n)
+{
+    unsigned char carry = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        LongChunk x;
+        carry = _addcarryx_u64(carry, a[i], b[i], &x);
+        r[i] = x;
+    }
+    return carry;
+}
+
+__attribute__((target("adx"))) static Chunk subNAdx(Chunk *r, const Chunk *a, const Chunk *b, const std::size_t n, const Chunk borrowIn)
+{
+    auto borrow = static_cast<unsigned char>(borrowIn);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        LongChunk x;
+        borrow = _subborrow_u64(borrow, a[i], b[i], &x);
+        r[i] = x;
+    }
+    return borrow;
+}
+
+__attribute__((target("adx,bmi2"))) static Chunk addMul1Adx(Chunk *r, const Chunk *a, const std::size_t n, const Chunk m)
+{
+    unsigned char prodCarry = 0, sumCarry = 0;
+    LongChunk prevHi = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        LongChunk hi, lo, x;
+        lo = _mulx_u64(a[i], m, &hi);
+        prodCarry = _addcarryx_u64(prodCarry, lo, prevHi, &lo);
+        sumCarry = _addcarryx_u64(sumCarry, r[i], lo, &x);
+        r[i] = x;
+        prevHi = hi;
+    }
+    return prevHi + prodCarry + sumCarry;
+}
+
+__attribute__((target("adx,bmi2"))) static Chunk subMul1Adx(Chunk *r, const Chunk *a, const std::size_t n, const Chunk m)
+{
+    unsigned char prodCarry = 0, borrow = 0;
+    LongChunk prevHi = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        LongChunk hi, lo, x;
+        lo = _mulx_u64(a[i], m, &hi);
+        prodCarry = _addcarryx_u64(prodCarry, lo, prevHi, &lo);
+        borrow = _subborrow_u64(borrow, r[i], lo, &x);
+        r[i] = x;
+        prevHi = hi;
+    }
+    return prevHi + prodCarry + borrow;
+}
+
+static constexpr ChunkKernels AdxKernels{addNAdx, subNAdx, addMul1Adx, subMul1Adx};
+
+static bool cpuHasAdx()
+{
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return false;
+    return (ebx & bit_BMI2) && (ebx & bit_ADX);
+}
+
+static std::atomic<const ChunkKernels *> forcedKernels{nullptr};
+
+static const ChunkKernels &kernels()
+{
+    if (const auto k = forcedKernels.load(std::memory_order_relaxed))
+        return *k;
+    static const auto &detected = cpuHasAdx() ? AdxKernels : PortableKernels;
+    return detected;
+}
+#else
+static const ChunkKernels &kernels() { return PortableKernels; }
+#endif
+
+static Chunk addN(Chunk *r, const Chunk *a, const Chunk *b, const std::size_t n) { return kernels().addN(r, a, b, n); }
+
+static Chunk subN(Chunk *r, const Chunk *a, const Chunk *b, const std::size_t n, const Chunk borrow = 0)
+{
+    return kernels().subN(r, a, b, n, borrow);
+}
+
+static Chunk addMul1(Chunk *r, const Chunk *a, const std::size_t n, const Chunk m) { return kernels().addMul1(r, a, n, m); }
+static Chunk subMul1(Chunk *r, const Chunk *a, const std::size_t n, const Chunk m) { return kernels().subMul1(r, a, n, m); }
+
+bool BigIntKernels::available(const Kind kind)
+{
+#ifdef BIGINT_ADX_KERNELS
+    if (kind == Kind::Adx)
+        return cpuHasAdx();
+#endif
+    return kind == Kind::Portable;
+}
+
+BigIntKernels::Kind BigIntKernels::active() { return &kernels() == &PortableKernels ? Kind::Portable : Kind::Adx; }
+
+void BigIntKernels::force(const Kind kind)
+{
+    if (!available(kind))
+        throw std::invalid_argument("BigIntKernels force has unavailable kind");
+#ifdef BIGINT_ADX_KERNELS
+    forcedKernels = kind == Kind::Adx ? &AdxKernels : &PortableKernels;
+#endif
+}
+
+void BigIntKernels::reset()
+{
+#ifdef BIGINT_ADX_KERNELS
+    forcedKernels = nullptr;
+#endif
+}
+
+// r = a + b for an >= bn, returns the carry out
+static Chunk addNM(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn)
+{
+    auto carry = addN(r, a, b, bn);
+    for (auto i = bn; i < an; ++i)
+    {
+        r[i] = a[i] + carry;
+        carry = r[i] < carry;
+    }
+    return carry;
+}
+
+// r = a - b for an >= bn, returns the borrow out
+static Chunk subNM(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn)
+{
+    auto borrow = subN(r, a, b, bn);
+    for (auto i = bn; i < an; ++i)
+    {
+        const auto x = a[i];
+        r[i] = x - borrow;
+        borrow = x < borrow;
+    }
+    return borrow;
+}
+
+// r += a for an <= rn, the carry only ripples as far as it has to and is
+// returned when it runs out of r
+static Chunk addInto(Chunk *r, const std::size_t rn, const Chunk *a, const std::size_t an)
+{
+    auto carry = addN(r, r, a, an);
+    for (auto i = an; carry && i < rn; ++i)
+    {
+        carry = ++r[i] == 0;
+    }
+    return carry;
+}
+
+// r -= a for r >= a, the borrow only ripples as far as it has to
+static void subInto(Chunk *r, const std::size_t rn, const Chunk *a, const std::size_t an)
+{
+    auto borrow = subN(r, r, a, an);
+    for (auto i = an; borrow && i < rn; ++i)
+    {
+        borrow = r[i]-- == 0;
+    }
+}
+
+static std::strong_ordering cmpNM(const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn)
+{
+    if (an == bn)
+    {
+        for (auto i = an; i--;)
+        {
+            if (a[i] != b[i])
+                return a[i] <=> b[i];
+        }
+        return std::strong_ordering::equal;
+    }
+    for (auto i = std::max(an, bn); i--;)
+    {
+        const auto x = i < an ? a[i] : 0, y = i < bn ? b[i] : 0;
+        if (x != y)
+            return x <=> y;
+    }
+    return std::strong_ordering::equal;
+}
+
+// r = |x - y| for xn >= yn with r having xn chunks, returns whether x < y
+static bool absDiff(Chunk *r, const Chunk *x, const std::size_t xn, const Chunk *y, const std::size_t yn)
+{
+    if (cmpNM(x, xn, y, yn) < 0)
+    {
+        subN(r, y, x, yn);
+        std::fill(r + yn, r + xn, 0);
+        return true;
+    }
+    subNM(r, x, xn, y, yn);
+    return false;
+}
+
+// two's complement negation modulo 2^(n * ChunkBits)
+static void negateN(Chunk *r, const std::size_t n)
+{
+    std::size_t i = 0;
+    while (i < n && r[i] == 0)
+    {
+        ++i;
+    }
+    if (i < n)
+        r[i] = ~r[i] + 1;
+    while (++i < n)
+    {
+        r[i] = ~r[i];
+    }
+}
+
+// shifts by 0 < s < ChunkBits, lshiftN returns the bits shifted out
+static Chunk lshiftN(Chunk *r, const Chunk *a, const std::size_t n, const int s)
+{
+    const Chunk out = a[n - 1] >> (ChunkBits - s);
+    for (auto i = n - 1; i > 0; --i)
+    {
+        r[i] = a[i] << s | a[i - 1] >> (ChunkBits - s);
+    }
+    r[0] = a[0] << s;
+    return out;
+}
+
+static void rshiftN(Chunk *r, const Chunk *a, const std::size_t n, const int s)
+{
+    for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+        r[i] = a[i] >> s | a[i + 1] << (ChunkBits - s);
+    }
+    r[n - 1] = a[n - 1] >> s;
+}
+
+// inverse of an odd d modulo 2^ChunkBits, d is its own inverse to 3 bits and
+// each Newton step doubles that
+static constexpr Chunk chunkInverse(const Chunk d)
+{
+    Chunk inv = d;
+    for (int bits = 3; bits < ChunkBits; bits *= 2)
+    {
+        inv *= 2 - d * inv;
+    }
+    return inv;
+}
+
+// exact division by a small odd d modulo 2^(n * ChunkBits) using the inverse
+// of d, so the dividend may be a negative two's complement value
+static void divExactOdd(Chunk *r, const std::size_t n, const Chunk d)
+{
+    const auto inv = chunkInverse(d);
+    Chunk borrow = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const auto x = r[i];
+        const Chunk q = (x - borrow) * inv;
+        r[i] = q;
+        borrow = (x < borrow) + static_cast<Chunk>(static_cast<DoubleChunk>(q) * d >> ChunkBits);
+    }
+}
+
+// r = a * m, returns the carry out
+static Chunk mul1(Chunk *r, const Chunk *a, const std::size_t n, const Chunk m)
+{
+    Chunk carry = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const auto prod = static_cast<DoubleChunk>(a[i]) * m + carry;
+        r[i] = static_cast<Chunk>(prod);
+        carry = static_cast<Chunk>(prod >> ChunkBits);
+    }
+    return carry;
+}
+
+// q = a / d for d > 0, returns the remainder. q may be null when only the
+// remainder is needed, which then also runs through zeros implicit low chunks.
+static Chunk divRem1(Chunk *q, const Chunk *a, const std::size_t n, const Chunk d, const std::size_t zeros = 0)
+{
+    DoubleChunk rem = 0;
+    for (auto i = n; i--;)
+    {
+        const auto cur = rem << ChunkBits | a[i];
+        if (q)
+            q[i] = static_cast<Chunk>(cur / d);
+        rem = cur % d;
+    }
+    for (std::size_t i = 0; i < zeros; ++i)
+    {
+        rem = (rem << ChunkBits) % d;
+    }
+    return static_cast<Chunk>(rem);
+}
+
+static constexpr std::size_t NativeChunks = sizeof(std::uint64_t) / sizeof(Chunk);
+
+// views a native operand through buf without allocating
+static BigIntView nativeView(std::array<Chunk, NativeChunks> &buf, const BigIntNative num)
+{
+    for (std::size_t i = 0; i < NativeChunks; ++i)
+    {
+        buf[i] = static_cast<Chunk>(num.mag >> i * ChunkBits);
+    }
+    BigIntView res(buf, num.isNeg);
+    res.normalize();
+    return res;
+}
+
+static std::strong_ordering cmpMag(const BigIntView lhs, const BigIntView rhs)
+{
+    if (lhs.offset == rhs.offset)
+        return cmpNM(lhs.chunks.data(), lhs.chunks.size(), rhs.chunks.data(), rhs.chunks.size());
+    const auto size = lhs.offset + lhs.chunks.size();
+    if (size != rhs.offset + rhs.chunks.size())
+        return size <=> rhs.offset + rhs.chunks.size();
+    for (auto i = size; i-- > std::min(lhs.offset, rhs.offset);)
+    {
+        const auto a = chunkAt(lhs, i), b = chunkAt(rhs, i);
+        if (a != b)
+            return a <=> b;
+    }
+    return std::strong_ordering::equal;
+}
+
+static void lowerOffset(BigInt &big, const std::size_t offset)
+{
+    if (big.offset <= offset)
+        return;
+    const auto n = big.offset - offset;
+    const auto sz = big.chunks.size();
+    big.chunks.resize(sz + n);
+    const auto data = big.chunks.data();
+    std::copy_backward(data, data + sz, data + sz + n);
+    std::fill(data, data + n, 0);
+    big.offset = offset;
+}
+
+// lines up acc with other and returns the position of other's chunks in acc
+static std::size_t alignOffset(BigInt &acc, const BigIntView other)
+{
+    if (acc.chunks.empty())
+        acc.offset = other.offset;
+    lowerOffset(acc, other.offset);
+    return other.offset - acc.offset;
+}
+
+// acc = |acc| + |other| keeping acc's sign
+static void add(BigInt &acc, const BigIntView other)
+{
+    if (other.chunks.empty())
+        return;
+    const auto pos = alignOffset(acc, other);
+    acc.chunks.resize(std::max(acc.chunks.size(), pos + other.chunks.size()));
+    if (addInto(acc.chunks.data() + pos, acc.chunks.size() - pos, other.chunks.data(), other.chunks.size()))
+        acc.chunks.push_back(1);
+}
+
+// acc = |acc| - |other| keeping acc's sign, the magnitudes are compared first
+// so the smaller one is subtracted from the larger one in a single pass
+static void sub(BigInt &acc, const BigIntView other)
+{
+    if (other.chunks.empty())
+        return;
+    const auto cmp = cmpMag(acc, other);
+    if (cmp == 0)
+    {
+        acc.chunks.clear();
+        acc.normalize();
+        return;
+    }
+    const auto pos = alignOffset(acc, other);
+    const auto on = other.chunks.size();
+    if (cmp > 0)
+        subInto(acc.chunks.data() + pos, acc.chunks.size() - pos, other.chunks.data(), on);
+    else
+    {
+        acc.chunks.resize(pos + on);
+        const auto r = acc.chunks.data();
+        Chunk borrow = 0;
+        for (std::size_t i = 0; i < pos; ++i)
+        {
+            const auto x = r[i];
+            r[i] = 0 - x - borrow;
+            borrow = (x | borrow) != 0;
+        }
+        subN(r + pos, other.chunks.data(), r + pos, on, borrow);
+        acc.isNeg = !acc.isNeg;
+    }
+    acc.normalize();
+}
+
+static void addSigned(BigInt &acc, const BigIntView other)
+{
+    if (acc.isNeg == other.isNeg)
+        add(acc, other);
+    else
+        sub(acc, other);
+}
+
+static void subSigned(BigInt &acc, const BigIntView other)
+{
+    if (acc.isNeg != other.isNeg)
+        add(acc, other);
+    else
+        sub(acc, other);
+}
+
+static bool overlaps(const BigInt &big, const BigIntView view)
+{
+    const auto first = big.chunks.data(), last = first + big.chunks.size();
+    const auto p = view.chunks.data();
+    return std::less_equal<>()(first, p) && std::less<>()(p, last);
+}
+
+// whether view is all of big
+static bool viewsAll(const BigInt &big, const BigIntView view)
+{
+    return view.chunks.data() == big.chunks.data() && view.chunks.size() == big.chunks.size() && view.offset == big.offset && view.isNeg == big.isNeg;
+}
+
+// dst = val keeping dst's buffer, val may view dst's own chunks
+static void assignView(BigInt &dst, const BigIntView val)
+{
+    if (viewsAll(dst, val))
+        return;
+    if (overlaps(dst, val))
+    {
+        dst = BigInt(val);
+        return;
+    }
+    dst.chunks.assign(val.chunks.data(), val.chunks.data() + val.chunks.size());
+    dst.offset = val.offset;
+    dst.isNeg = val.isNeg;
+    dst.normalize();
+}
+
+BigInt::BigInt() {}
+
+BigInt::BigInt(int num) : BigInt(static_cast<long long>(num)) {}
+BigInt::BigInt(long num) : BigInt(static_cast<long long>(num)) {}
+BigInt::BigInt(const long long num) : BigInt(static_cast<unsigned long long>(num))
+{
+    if (num < 0)
+    {
+        bool borrow = true;
+        for (auto &chunk : chunks)
+        {
+            if (borrow)
+                borrow = --chunk == static_cast<Chunk>(-1);
+            chunk = ~chunk;
+        }
+        isNeg = true;
+        normalize();
+    }
+}
+
+BigInt::BigInt(unsigned num) : BigInt(static_cast<unsigned long long>(num)) {}
+BigInt::BigInt(unsigned long num) : BigInt(static_cast<unsigned long long>(num)) {}
+BigInt::BigInt(unsigned long long num)
+{
+    for (std::size_t i = 0; i < sizeof(num) / sizeof(Chunk) && num >> i * ChunkBits; ++i)
+    {
+        chunks.push_back(static_cast<Chunk>(num >> i * ChunkBits));
+    }
+}
+
+template <typename T>
+void floatConvert(BigInt &big, T t)
+{
+    if (!std::isnormal(t))
+        return;
+    int exp;
+    auto fr = std::frexp(std::trunc(t), &exp);
+    if (fr < 0.0)
+    {
+        fr = -fr;
+        big.isNeg = true;
+    }
+    big.chunks.resize(ceilDiv(exp, ChunkBits));
+    for (std::size_t i = big.chunks.size(); i--;)
+    {
+        auto &chunk = big.chunks[i];
+        auto j = exp % ChunkBits;
+        if (j == 0)
+            j = ChunkBits;
+        while (j--)
+        {
+            chunk <<= 1;
+            if (fr >= 0.5)
+            {
+                chunk |= 0x1;
+                fr -= 0.5;
+                if (fr == 0.0)
+                {
+                    chunk <<= j;
+                    return;
+                }
+            }
+            fr *= 2.0;
+            --exp;
+        }
+    }
+}
+
+BigInt::BigInt(float num) { floatConvert(*this, num); }
+BigInt::BigInt(double num) { floatConvert(*this, num); }
+BigInt::BigInt(long double num) { floatConvert(*this, num); }
+
+BigInt::BigInt(const BigIntView view)
+    : chunks(view.chunks.data(), view.chunks.data() + view.chunks.size()), offset(view.offset), isNeg(view.isNeg)
+{
+    normalize();
+}
+
+BigInt &BigInt::operator+=(const BigInt &other)
+{
+    if (this == &other)
+    {
+        auto rhsCopy = other;
+        return *this += rhsCopy;
+    }
+    addSigned(*this, other);
+    return *this;
+}
+
+BigInt &BigInt::operator+=(BigInt &&other)
+{
+    if (other.chunks.capacity() > chunks.capacity())
+        std::swap(*this, other);
+    return *this += other;
+}
+
+BigInt &BigInt::operator-=(const BigInt &other)
+{
+    if (this == &other)
+        return *this = Zero;
+    subSigned(*this, other);
+    return *this;
+}
+
+BigInt &BigInt::operator-=(BigInt &&other)
+{
+    if (other.chunks.capacity() > chunks.capacity())
+    {
+        std::swap(*this, other);
+        negate();
+        return *this += other;
+    }
+    return *this -= other;
+}
+
+BigInt &BigInt::operator*=(const BigInt &other)
+{
+    mul(*this, *this, other);
+    return *this;
+}
+
+BigInt &BigInt::operator*=(BigInt &&other)
+{
+    if (other.chunks.capacity() > chunks.capacity())
+        std::swap(*this, other);
+    return *this *= other;
+}
+
+BigInt &BigInt::operator/=(const BigInt &other) { return *this = std::move(*this) / other; }
+BigInt &BigInt::operator/=(BigInt &&other) { return *this = std::move(*this) / std::move(other); }
+BigInt &BigInt::operator%=(const BigInt &other) { return *this = std::move(*this) % other; }
+BigInt &BigInt::operator%=(BigInt &&other) { return *this = std::move(*this) % std::move(other); }
+
+// a[i] = op(a[i], b[i]), kept as a plain loop over raw pointers so it inlines
+// the operator and vectorizes
+template <typename Op>
+static void bitwiseN(Chunk *a, const Chunk *b, const std::size_t n, const Op op)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = op(a[i], b[i]);
+    }
+}
+
+// a[i] = op(a[i], ~b[i])
+template <typename Op>
+static void bitwiseNotN(Chunk *a, const Chunk *b, const std::size_t n, const Op op)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = op(a[i], static_cast<Chunk>(~b[i]));
+    }
+}
+
+// a[i] = op(a[i], b) for a constant b
+template <typename Op>
+static void bitwiseFill(Chunk *a, const std::size_t n, const Chunk b, const Op op)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = op(a[i], b);
+    }
+}
+
+// lhs = op(lhs, rhs) on the two's complement values. Non-negative operands go
+// straight through bitwiseN, a negative rhs is complemented on the fly past
+// its first nonzero chunk, and a negative lhs or result is one negateN pass.
+// Both two's complement values are zero below their offsets, as is op(0, 0),
+// so the work starts at the lower of the two offsets like add and sub.
+template <typename Op>
+static void bitwise(BigInt &lhs, const BigIntView rhs, const Op op)
+{
+    const auto pos = alignOffset(lhs, rhs);
+    const Chunk lhsFill = lhs.isNeg ? static_cast<Chunk>(-1) : 0;
+    const Chunk rhsFill = rhs.isNeg ? static_cast<Chunk>(-1) : 0;
+    const bool resIsNeg = op(lhsFill, rhsFill) != 0;
+    const auto rhsEnd = pos + rhs.chunks.size();
+    auto n = std::max(lhs.chunks.size(), rhsEnd) + (resIsNeg ? 1 : 0);
+    if constexpr (std::is_same_v<Op, std::bit_and<Chunk>>)
+    {
+        // chunks past a non-negative operand are zero in the result
+        if (!lhs.isNeg)
+            n = std::min(n, lhs.chunks.size());
+        if (!rhs.isNeg)
+            n = std::min(n, rhsEnd);
+    }
+    lhs.chunks.resize(n);
+    const auto a = lhs.chunks.data();
+    if (lhs.isNeg)
+        negateN(a, n);
+    // rhs is zero below its offset whatever its sign
+    const auto lo = std::min(pos, n);
+    bitwiseFill(a, lo, 0, op);
+    const auto b = rhs.chunks.data();
+    const auto bn = std::min(rhs.chunks.size(), n - lo);
+    if (!rhs.isNeg)
+        bitwiseN(a + lo, b, bn, op);
+    else
+    {
+        const auto k = static_cast<std::size_t>(std::find_if(b, b + bn, [](Chunk x)
+                                                             { return x != 0; }) -
+                                                b);
+        bitwiseFill(a + lo, k, 0, op);
+        if (k < bn)
+        {
+            a[lo + k] = op(a[lo + k], static_cast<Chunk>(0 - b[k]));
+            bitwiseNotN(a + lo + k + 1, b + k + 1, bn - k - 1, op);
+        }
+    }
+    bitwiseFill(a + lo + bn, n - lo - bn, rhsFill, op);
+    if (resIsNeg)
+        negateN(a, n);
+    lhs.isNeg = resIsNeg;
+    lhs.normalize();
+}
+
+BigInt &BigInt::operator&=(const BigInt &other)
+{
+    if (this == &other)
+        return *this;
+    bitwise(*this, other, std::bit_and<Chunk>());
+    return *this;
+}
+
+BigInt &BigInt::operator&=(BigInt &&other)
+{
+    if (other.chunks.capacity() > chunks.capacity())
+        std::swap(*this, other);
+    return *this &= other;
+}
+
+BigInt &BigInt::operator|=(const BigInt &other)
+{
+    if (this == &other)
+        return *this;
+    bitwise(*this, other, std::bit_or<Chunk>());
+    return *this;
+}
+
+BigInt &BigInt::operator|=(BigInt &&other)
+{
+    if (other.chunks.capacity() > chunks.capacity())
+        std::swap(*this, other);
+    return *this |= other;
+}
+
+BigInt &BigInt::operator^=(const BigInt &other)
+{
+    if (this == &other)
+        return *this = Zero;
+    bitwise(*this, other, std::bit_xor<Chunk>());
+    return *this;
+}
+
+BigInt &BigInt::operator^=(BigInt &&other)
+{
+    if (other.chunks.capacity() > chunks.capacity())
+        std::swap(*this, other);
+    return *this ^= other;
+}
+
+BigInt &BigInt::operator<<=(const std::int64_t n)
+{
+    if (n < 0)
+        throw std::invalid_argument("BigInt operator<<= has negative shift");
+    if (n == 0 || chunks.empty())
+        return *this;
+    offset += n / ChunkBits;
+    const int s = n % ChunkBits;
+    if (s == 0)
+        return *this;
+    const auto data = chunks.data();
+    if (const auto out = lshiftN(data, data, chunks.size(), s))
+        chunks.push_back(out);
+    return *this;
+}
+
+BigInt &BigInt::operator>>=(std::int64_t n)
+{
+    if (n < 0)
+        throw std::invalid_argument("BigInt operator>>= has negative shift");
+    const auto skip = std::min(offset, static_cast<std::size_t>(n / ChunkBits));
+    offset -= skip;
+    n -= static_cast<std::int64_t>(skip) * ChunkBits;
+    if (n == 0 || chunks.empty())
+        return *this;
+    if (offset)
+    {
+        // n < ChunkBits is left here and no set bits fall off, so shift left
+        // into the zero chunk below instead of moving everything up
+        --offset;
+        const auto data = chunks.data();
+        if (const auto out = lshiftN(data, data, chunks.size(), ChunkBits - static_cast<int>(n)))
+            chunks.push_back(out);
+        normalize();
+        return *this;
+    }
+    if (static_cast<std::size_t>(n) >= chunks.size() * ChunkBits)
+    {
+        chunks.clear();
+        if (isNeg)
+            chunks.push_back(1);
+        return *this;
+    }
+    const std::size_t off = n / ChunkBits;
+    const int s = n % ChunkBits;
+    const auto data = chunks.data();
+    // a negative value rounds toward -inf, so its magnitude goes up by one
+    // when any set bits are shifted out
+    const bool roundUp = isNeg && (std::any_of(data, data + off, [](Chunk x)
+                                               { return x != 0; }) ||
+                                   (s && data[off] << (ChunkBits - s)));
+    const auto sz = chunks.size() - off;
+    if (off)
+        std::memmove(data, data + off, sz * sizeof(Chunk));
+    if (s)
+        rshiftN(data, data, sz, s);
+    chunks.resize(sz);
+    if (roundUp && addChunk(chunks, 0, 1))
+        chunks.push_back(1);
+    normalize();
+    return *this;
+}
+
+BigInt &BigInt::operator++() { return addNative(1); }
+BigInt &BigInt::operator--() { return subNative(1); }
+
+BigInt BigInt::operator++(int)
+{
+    auto res = *this;
+    ++*this;
+    return res;
+}
+
+BigInt BigInt::operator--(int)
+{
+    auto res = *this;
+    --*this;
+    return res;
+}
+
+BigInt BigInt::operator-() const &
+{
+    auto res = *this;
+    res.negate();
+    return res;
+}
+
+BigInt BigInt::operator-() &&
+{
+    negate();
+    return std::move(*this);
+}
+
+BigInt BigInt::operator~() const &
+{
+    auto res = *this;
+    res.invert();
+    return res;
+}
+
+BigInt BigInt::operator~() &&
+{
+    invert();
+    return std::move(*this);
+}
+
+BigInt::operator bool() const { return chunks.size(); }
+
+void BigInt::negate()
+{
+    if (chunks.empty())
+        return;
+    isNeg = !isNeg;
+}
+
+void BigInt::normalize()
+{
+    while (chunks.size() && chunks.back() == 0)
+    {
+        chunks.pop_back();
+    }
+    if (chunks.size() == 0)
+    {
+        isNeg = false;
+        offset = 0;
+    }
+}
+
+void BigInt::flatten() { lowerOffset(*this, 0); }
+
+// ~x = -x - 1, one added to or taken from the magnitude through add and sub
+// rather than flattening first. The low chunk of the result is never zero, so
+// those lower the offset, but only as far as that chunk.
+void BigInt::invert()
+{
+    std::array<Chunk, 1> one{1};
+    if (isNeg)
+        ::sub(*this, BigIntView(one, false, 0));
+    else
+        ::add(*this, BigIntView(one, false, 0));
+    negate();
+}
+
+std::int64_t BigIntView::bitLength() const
+{
+    auto view = *this;
+    view.normalize();
+    if (view.chunks.empty())
+        return 0;
+    return static_cast<std::int64_t>(view.offset + view.chunks.size() - 1) * ChunkBits + std::bit_width(view.chunks.back());
+}
+
+std::int64_t BigIntView::popcount() const
+{
+    std::int64_t res = 0;
+    for (const auto x : chunks)
+    {
+        res += std::popcount(x);
+    }
+    return res;
+}
+
+std::int64_t BigIntView::countTrailingZeros() const
+{
+    const auto it = std::find_if(chunks.begin(), chunks.end(), [](Chunk x)
+                                 { return x != 0; });
+    if (it == chunks.end())
+        return 0;
+    return static_cast<std::int64_t>(offset + (it - chunks.begin())) * ChunkBits + std::countr_zero(*it);
+}
+
+static void checkBitIndex(const std::int64_t i, const char *msg)
+{
+    if (i < 0)
+        throw std::invalid_argument(msg);
+}
+
+// bit i of the magnitude
+static bool magBit(const BigIntView big, const std::int64_t i)
+{
+    const auto j = static_cast<std::size_t>(i / BigInt::ChunkBits);
+    if (j < big.offset || j - big.offset >= big.chunks.size())
+        return false;
+    return big.chunks[j - big.offset] >> (i % BigInt::ChunkBits) & 1;
+}
+
+bool BigIntView::testBit(const std::int64_t i) const
+{
+    checkBitIndex(i, "BigInt testBit has negative index");
+    if (!isNeg)
+        return magBit(*this, i);
+    // -m is ~(m - 1), which matches m up to and including its lowest set bit
+    // and is the complement of m above it
+    const auto low = countTrailingZeros();
+    return i <= low ? i == low : !magBit(*this, i);
+}
+
+std::int64_t BigInt::bitLength() const { return BigIntView(*this).bitLength(); }
+std::int64_t BigInt::popcount() const { return BigIntView(*this).popcount(); }
+std::int64_t BigInt::countTrailingZeros() const { return BigIntView(*this).countTrailingZeros(); }
+bool BigInt::testBit(const std::int64_t i) const { return BigIntView(*this).testBit(i); }
+
+// 1 << i as a single chunk view
+static BigIntView bitView(std::array<Chunk, 1> &buf, const std::int64_t i)
+{
+    buf[0] = static_cast<Chunk>(1) << (i % ChunkBits);
+    return BigIntView(buf, false, i / ChunkBits);
+}
+
+// Setting a clear bit of the two's complement adds 1 << i and clearing a set
+// one subtracts it, for either sign, so the carry only ripples as far as it
+// has to.
+BigInt &BigInt::setBit(const std::int64_t i)
+{
+    checkBitIndex(i, "BigInt setBit has negative index");
+    std::array<Chunk, 1> buf;
+    if (!testBit(i))
+        addSigned(*this, bitView(buf, i));
+    return *this;
+}
+
+BigInt &BigInt::clearBit(const std::int64_t i)
+{
+    checkBitIndex(i, "BigInt clearBit has negative index");
+    std::array<Chunk, 1> buf;
+    if (testBit(i))
+        subSigned(*this, bitView(buf, i));
+    return *this;
+}
+
+// flips bit i of the magnitude in its chunk, growing the chunks or lowering
+// the offset only when the bit lies outside them
+static void flipMagBit(BigInt &big, const std::int64_t i)
+{
+    const auto j = static_cast<std::size_t>(i / ChunkBits);
+    if (big.chunks.empty())
+        big.offset = j;
+    lowerOffset(big, j);
+    const auto k = j - big.offset;
+    if (k >= big.chunks.size())
+        big.chunks.resize(k + 1);
+    big.chunks[k] ^= static_cast<Chunk>(1) << (i % ChunkBits);
+    big.normalize();
+}
+
+// Above the lowest set bit of a negative value its two's complement bits are
+// the complemented magnitude bits, so flipping one there is a magnitude flip
+// too. At or below it the carry ripples, which setBit and clearBit handle.
+BigInt &BigInt::flipBit(const std::int64_t i)
+{
+    checkBitIndex(i, "BigInt flipBit has negative index");
+    if (isNeg)
+    {
+        if (const auto low = countTrailingZeros(); i <= low)
+        {
+            std::array<Chunk, 1> buf;
+            if (i == low)
+                subSigned(*this, bitView(buf, i));
+            else
+                addSigned(*this, bitView(buf, i));
+            return *this;
+        }
+    }
+    flipMagBit(*this, i);
+    return *this;
+}
+
+std::int64_t BigInt::toInteger() const
+{
+    std::int64_t res = 0;
+    bool borrow = true;
+    for (std::size_t i = 0; i < sizeof(res) / sizeof(Chunk); ++i)
+    {
+        auto chunk = chunkAt(*this, i);
+        if (isNeg)
+        {
+            if (borrow)
+                borrow = --chunk == static_cast<Chunk>(-1);
+            chunk = ~chunk;
+        }
+        res |= static_cast<std::uint64_t>(chunk) << i * ChunkBits;
+    }
+    return res;
+}
+
+template <typename T>
+T floatConvert(const BigInt &big)
+{
+    T res = 0.0;
+    const auto n = sizeof(T) / sizeof(Chunk) + 1;
+    const T chunkMag = std::ldexp(static_cast<T>(1.0), ChunkBits);
+    const auto total = big.offset + big.chunks.size();
+    for (auto i = total, j = n; i-- && j--;)
+    {
+        res *= chunkMag;
+        res += chunkAt(big, i);
+    }
+    if (total > n)
+        res *= static_cast<T>(std::pow(chunkMag, total - n));
+    if (big.isNeg)
+        res = -res;
+    return res;
+}
+
+float BigInt::toFloat() const { return floatConvert<float>(*this); }
+double BigInt::toDouble() const { return floatConvert<double>(*this); }
+long double BigInt::toLongDouble() const { return floatConvert<long double>(*this); }
+
+std::string BigInt::toString() const & { return BigInt(*this).toString(); }
+
+std::string BigInt::toString() &&
+{
+    if (*this == 0)
+        return "0";
+    std::string res = isNeg ? "-" : "";
+    std::vector<std::string> digits;
+    while (*this)
+    {
+        auto [q, r] = divmod(std::move(*this), TenQuintillion);
+        std::uint64_t val = 0;
+        for (std::size_t i = 0; i < r.chunks.size(); ++i)
+        {
+            val |= static_cast<std::uint64_t>(r.chunks[i]) << i * ChunkBits;
+        }
+        digits.push_back(std::to_string(val));
+        *this = std::move(q);
+    }
+    auto first = true;
+    for (std::size_t i = digits.size(); i--;)
+    {
+        if (!first && digits[i].size() < 19)
+            res += std::string(19 - digits[i].size(), '0');
+        res += digits[i];
+        first = false;
+    }
+    return res;
+}
+
+std::string BigInt::toHex() const
+{
+    if (*this == 0)
+        return "0x0";
+    std::string res = isNeg ? "-0x" : "0x";
+    std::vector<std::string> hexChunks(offset + chunks.size(), std::string(ChunkBits / 4, '0'));
+    for (std::size_t i = 0; i < hexChunks.size(); ++i)
+    {
+        auto chunk = chunkAt(*this, i);
+        auto &hexChunk = hexChunks[i];
+        for (std::size_t j = hexChunk.size(); j-- && chunk;)
+        {
+            auto off = chunk % 16;
+            chunk /= 16;
+            hexChunk[j] = static_cast<char>(off < 10 ? '0' + off
+                                                     : 'a' + off - 10);
+        }
+    }
+    auto &lastHexChunk = hexChunks.back();
+    lastHexChunk = lastHexChunk.substr(lastHexChunk.find_first_not_of('0'));
+    for (std::size_t i = hexChunks.size(); i--;)
+    {
+        res += hexChunks[i];
+    }
+    return res;
+}
+
+BigInt BigInt::fromString(std::string_view str)
+{
+    constexpr auto exceptionMsg = "BigInt fromString has invalid argument";
+    bool strIsNeg = str.size() && str[0] == '-';
+    if (strIsNeg)
+        str.remove_prefix(1);
+    if (str.size() == 0)
+        throw std::invalid_argument(exceptionMsg);
+    BigInt res;
+    while (str.size())
+    {
+        auto sub = str.substr(0, str.size() % 19 == 0 ? 19 : str.size() % 19);
+        std::uint64_t tmp;
+        auto fcRes = std::from_chars(sub.data(), sub.data() + sub.size(), tmp);
+        if (fcRes.ec != std::errc{} || fcRes.ptr != sub.data() + sub.size())
+            throw std::invalid_argument(exceptionMsg);
+        res *= 10'000'000'000'000'000'000ull;
+        res += tmp;
+        str.remove_prefix(sub.size());
+    }
+    if (strIsNeg)
+        res.negate();
+    return res;
+}
+
+BigInt BigInt::fromHex(std::string_view str)
+{
+    constexpr auto exceptionMsg = "BigInt fromHex has invalid argument";
+    bool strIsNeg = str.substr(0, 3) == "-0x"  ? true
+                    : str.substr(0, 2) == "0x" ? false
+                                               : throw std::invalid_argument(exceptionMsg);
+    str.remove_prefix(strIsNeg ? 3 : 2);
+    if (str.size() == 0)
+        throw std::invalid_argument(exceptionMsg);
+    BigInt res;
+    constexpr std::size_t digitsPerChunk = ChunkBits / 4;
+    res.chunks.resize(ceilDiv(str.size(), digitsPerChunk));
+    for (auto &chunk : res.chunks)
+    {
+        auto sub = str.substr(str.size() > digitsPerChunk ? str.size() - digitsPerChunk : 0);
+        str.remove_suffix(sub.size());
+        auto fcRes = std::from_chars(sub.data(), sub.data() + sub.size(), chunk, 16);
+        if (fcRes.ec != std::errc{} || fcRes.ptr != sub.data() + sub.size())
+            throw std::invalid_argument(exceptionMsg);
+    }
+    res.normalize();
+    if (strIsNeg)
+        res.negate();
+    return res;
+}
+
+// u[j, j + n] -= v * qhat over the n + 1 chunk window, returns whether it
+// went negative
+static bool divmodMulSub(BigInt &u, const BigInt &v, const std::size_t j, const Chunk qhat)
+{
+    const auto n = v.chunks.size();
+    if (u.chunks.size() < j + n + 1)
+        u.chunks.resize(j + n + 1);
+    const auto r = u.chunks.data() + j;
+    const auto borrow = subMul1(r, v.chunks.data(), n, qhat);
+    const auto top = r[n];
+    r[n] = top - borrow;
+    return top < borrow;
+}
+
+// u[j, j + n] += v, returns whether it carried out of the window, which means
+// the window is non-negative again
+static bool divmodAddBack(BigInt &u, const BigInt &v, const std::size_t j)
+{
+    const auto n = v.chunks.size();
+    const auto r = u.chunks.data() + j;
+    const auto carry = addN(r, r, v.chunks.data(), n);
+    return carry && ++r[n] == 0;
+}
+
+DivModRes BigInt::divmod(const BigInt &lhs, const BigInt &rhs) { return divmod(BigInt(lhs), BigInt(rhs)); }
+DivModRes BigInt::divmod(const BigInt &lhs, BigInt &&rhs) { return divmod(BigInt(lhs), std::move(rhs)); }
+DivModRes BigInt::divmod(BigInt &&lhs, const BigInt &rhs) { return divmod(std::move(lhs), BigInt(rhs)); }
+
+// q, r = r / rhs, r % rhs reusing q's buffer
+static void divmodInto(BigInt &q, BigInt &r, BigInt &&rhs)
+{
+    if (rhs == 0)
+        throw std::invalid_argument("BigInt divmod rhs is zero");
+    q.chunks.clear();
+    q.offset = 0;
+    r.flatten();
+    rhs.flatten();
+    q.isNeg = r.isNeg != rhs.isNeg;
+    const auto d = ChunkBits - static_cast<int>(std::bit_width(rhs.chunks.back()));
+    const auto v = std::move(rhs <<= d);
+    r <<= d;
+    const auto v1 = v.chunks.size() >= 1 ? v.chunks[v.chunks.size() - 1] : 0;
+    const auto v2 = v.chunks.size() >= 2 ? v.chunks[v.chunks.size() - 2] : 0;
+    const auto n = v.chunks.size();
+    if (r.chunks.size() + 1 > n)
+        q.chunks.resize(r.chunks.size() + 1 - n);
+    for (std::size_t j = q.chunks.size(); j--;)
+    {
+        DoubleChunk uu = r.chunks[j + n - 1];
+        if (j + n < r.chunks.size())
+            uu |= static_cast<DoubleChunk>(r.chunks[j + n]) << ChunkBits;
+        DoubleChunk qhat = uu / v1;
+        DoubleChunk rhat = uu % v1;
+        auto u2 = j + n >= 2 ? r.chunks[j + n - 2] : 0;
+        while (qhat >> ChunkBits || qhat * v2 > (rhat << ChunkBits | u2))
+        {
+            --qhat;
+            rhat += v1;
+            if (rhat >> ChunkBits)
+                break;
+        }
+        if (qhat == 0)
+            continue;
+        if (divmodMulSub(r, v, j, static_cast<Chunk>(qhat)))
+            do
+                --qhat;
+            while (!divmodAddBack(r, v, j));
+        r.normalize();
+        q.chunks[j] = static_cast<Chunk>(qhat);
+    }
+    q.normalize();
+    r >>= d;
+}
+
+DivModRes BigInt::divmod(BigInt &&lhs, BigInt &&rhs)
+{
+    DivModRes res{{}, std::move(lhs)};
+    divmodInto(res.q, res.r, std::move(rhs));
+    return res;
+}
+
+// After a carry every counter is below 2^ChunkBits and each added value puts
+// less than that in again, so a counter plus an incoming carry stays below
+// 2^(2 * ChunkBits) for well over this many additions, which leaves room to
+// merge in another accumulator.
+static constexpr std::uint64_t AccumulatorMaxPending = static_cast<Chunk>(-1) / 2;
+
+static void accumulate(std::vector<DoubleChunk> &counters, const BigIntView val)
+{
+    const auto n = val.offset + val.chunks.size();
+    if (counters.size() < n)
+        counters.resize(n);
+    const auto c = counters.data() + val.offset;
+    const auto a = val.chunks.data();
+    for (std::size_t i = 0; i < val.chunks.size(); ++i)
+    {
+        c[i] += a[i];
+    }
+}
+
+// leaves every counter below 2^ChunkBits
+static void carryCounters(std::vector<DoubleChunk> &counters)
+{
+    DoubleChunk carry = 0;
+    for (auto &x : counters)
+    {
+        x += carry;
+        carry = x >> ChunkBits;
+        x = static_cast<Chunk>(x);
+    }
+    if (carry)
+        counters.push_back(carry);
+}
+
+static BigInt resolveCounters(const std::vector<DoubleChunk> &counters)
+{
+    BigInt res;
+    res.chunks.resize(counters.size() + 1);
+    const auto r = res.chunks.data();
+    DoubleChunk carry = 0;
+    for (std::size_t i = 0; i < counters.size(); ++i)
+    {
+        const auto x = counters[i] + carry;
+        r[i] = static_cast<Chunk>(x);
+        carry = x >> ChunkBits;
+    }
+    r[counters.size()] = static_cast<Chunk>(carry);
+    res.normalize();
+    return res;
+}
 
-std::string BigInt::toString() const & { return BigInt(*this).toString(); }
+static void mergeCounters(std::vector<DoubleChunk> &counters, const std::vector<DoubleChunk> &other)
+{
+    if (counters.size() < other.size())
+        counters.resize(other.size());
+    for (std::size_t i = 0; i < other.size(); ++i)
+    {
+        counters[i] += other[i];
+    }
+}
 
-std::string BigInt::toString() &&
+static void reservePending(BigIntAccumulator &acc, const std::uint64_t n)
 {
-    if (*this == Zero())
-        return "0";
-    std::string res = isNeg ? "-" : "";
-    std::vector<std::string> digits;
-    while (*this)
+    if (acc.pending + n <= AccumulatorMaxPending)
+        return;
+    carryCounters(acc.pos);
+    carryCounters(acc.neg);
+    acc.pending = 0;
+}
+
+BigIntAccumulator &BigIntAccumulator::operator+=(const BigIntView val)
+{
+    reservePending(*this, 1);
+    ++pending;
+    accumulate(val.isNeg ? neg : pos, val);
+    return *this;
+}
+
+BigIntAccumulator &BigIntAccumulator::operator-=(const BigIntView val)
+{
+    reservePending(*this, 1);
+    ++pending;
+    accumulate(val.isNeg ? pos : neg, val);
+    return *this;
+}
+
+BigIntAccumulator &BigIntAccumulator::merge(const BigIntAccumulator &other)
+{
+    // other's counters count as its pending values plus one carried value
+    reservePending(*this, other.pending + 1);
+    pending += other.pending + 1;
+    mergeCounters(pos, other.pos);
+    mergeCounters(neg, other.neg);
+    return *this;
+}
+
+BigInt BigIntAccumulator::total() const { return resolveCounters(pos) - resolveCounters(neg); }
+
+void BigIntAccumulator::clear()
+{
+    pos.clear();
+    neg.clear();
+    pending = 0;
+}
+
+// An operand that views dst's chunks is copied first, unless dst only has to
+// take it in place
+void BigInt::add(BigInt &dst, BigIntView lhs, BigIntView rhs)
+{
+    if (viewsAll(dst, rhs))
+        std::swap(lhs, rhs);
+    BigInt copy;
+    if (overlaps(dst, rhs))
+        rhs = copy = BigInt(rhs);
+    assignView(dst, lhs);
+    addSigned(dst, rhs);
+}
+
+void BigInt::sub(BigInt &dst, const BigIntView lhs, BigIntView rhs)
+{
+    if (viewsAll(dst, rhs) && !overlaps(dst, lhs))
     {
-        auto [q, r] = divmod(*this, TenQuintillion());
-        std::uint64_t val = 0;
-        if (r.chunks.size() > 1)
-            val |= r.chunks[1];
-        val <<= 32;
-        if (r.chunks.size() > 0)
-            val |= r.chunks[0];
-        digits.push_back(std::to_string(val));
-        *this = std::move(q);
+        dst.negate();
+        addSigned(dst, lhs);
+        return;
     }
-    auto first = true;
-    for (std::size_t i = digits.size(); i--;)
+    BigInt copy;
+    if (overlaps(dst, rhs))
+        rhs = copy = BigInt(rhs);
+    assignView(dst, lhs);
+    subSigned(dst, rhs);
+}
+
+void BigInt::divmod(BigInt &q, BigInt &r, const BigIntView lhs, const BigIntView rhs)
+{
+    if (&q == &r)
+        throw std::invalid_argument("BigInt divmod q and r are the same object");
+    // the divisor is normalized in place, so it needs its own copy
+    BigInt v(rhs);
+    assignView(r, lhs);
+    divmodInto(q, r, std::move(v));
+}
+
+void BigInt::shiftLeft(BigInt &dst, const BigInt &lhs, const std::int64_t n)
+{
+    if (&dst != &lhs)
+        dst = lhs;
+    dst <<= n;
+}
+
+void BigInt::shiftRight(BigInt &dst, const BigInt &lhs, const std::int64_t n)
+{
+    if (&dst != &lhs)
+        dst = lhs;
+    dst >>= n;
+}
+
+BigInt BigInt::pow(const BigInt &base, std::int64_t exp)
+{
+    if (exp < 0)
+        throw std::invalid_argument("BigInt pow has negative exponent");
+    if (exp == 0)
+        return One;
+    auto x = base;
+    BigInt y = One;
+    while (exp > 1)
     {
-        if (!first && digits[i].size() < 19)
-            res += std::string(19 - digits[i].size(), '0');
-        res += digits[i];
-        first = false;
+        if (exp % 2)
+        {
+            y *= x;
+            --exp;
+        }
+        x *= x;
+        exp /= 2;
+    }
+    return x * y;
+}
+
+BigInt operator+(const BigInt &lhs, const BigInt &rhs)
+{
+    if (rhs.chunks.size() > lhs.chunks.size())
+    {
+        auto res = rhs;
+        res += lhs;
+        return res;
     }
+    auto res = lhs;
+    res += rhs;
     return res;
 }
 
-std::string BigInt::toHex() const
+BigInt operator+(const BigInt &lhs, BigInt &&rhs) { return std::move(rhs += lhs); }
+BigInt operator+(BigInt &&lhs, const BigInt &rhs) { return std::move(lhs += rhs); }
+
+BigInt operator+(BigInt &&lhs, BigInt &&rhs)
 {
-    if (*this == Zero())
-        return "0x0";
-    std::string res = isNeg ? "-0x" : "0x";
-    std::vector<std::string> hexChunks(chunks.size(), std::string(8, '0'));
-    for (std::size_t i = 0; i < chunks.size(); ++i)
+    if (rhs.chunks.capacity() > lhs.chunks.capacity())
+        return std::move(rhs += lhs);
+    return std::move(lhs += rhs);
+}
+
+BigInt operator-(const BigInt &lhs, const BigInt &rhs)
+{
+    if (rhs.chunks.size() > lhs.chunks.size())
+    {
+        auto res = rhs;
+        res.negate();
+        res += lhs;
+        return res;
+    }
+    if (&lhs == &rhs)
+        return Zero;
+    auto res = lhs;
+    res -= rhs;
+    return res;
+}
+
+BigInt operator-(const BigInt &lhs, BigInt &&rhs)
+{
+    if (&lhs == &rhs)
+        return std::move(rhs = Zero);
+    rhs.negate();
+    return std::move(rhs += lhs);
+}
+
+BigInt operator-(BigInt &&lhs, const BigInt &rhs) { return std::move(lhs -= rhs); }
+
+BigInt operator-(BigInt &&lhs, BigInt &&rhs)
+{
+    if (rhs.chunks.capacity() > lhs.chunks.capacity())
+        return lhs - std::move(rhs);
+    return std::move(lhs -= rhs);
+}
+
+// Multiplication works on raw chunk pointers. Every recursion level carves its
+// temporaries out of one scratch buffer sized up front by mulScratch, so a
+// product does two allocations: the result and the scratch.
+
+// row by row, the first row is stored by mul1 and the others accumulated by
+// addMul1, each producing exactly the one new top chunk of the result
+static void mulBasecase(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn)
+{
+    if (an == 0)
+    {
+        std::fill(r, r + bn, 0);
+        return;
+    }
+    r[bn] = mul1(r, b, bn, a[0]);
+    for (std::size_t i = 1; i < an; ++i)
+    {
+        r[i + bn] = addMul1(r + i, b, bn, a[i]);
+    }
+}
+
+// Each product a[i] * a[j] with i < j appears twice in a square, so those are
+// summed once by rows, doubled with a shift, and the squares a[i]^2 added on
+// the diagonal, about half the chunk products of mulBasecase.
+static void sqrBasecase(Chunk *r, const Chunk *a, const std::size_t n)
+{
+    std::fill(r, r + 2 * n, 0);
+    for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+        r[i + n] = addMul1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+    }
+    lshiftN(r, r, 2 * n, 1);
+    Chunk carry = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const auto sq = static_cast<DoubleChunk>(a[i]) * a[i];
+        const auto lo = static_cast<DoubleChunk>(r[2 * i]) + static_cast<Chunk>(sq) + carry;
+        r[2 * i] = static_cast<Chunk>(lo);
+        const auto hi = static_cast<DoubleChunk>(r[2 * i + 1]) + static_cast<Chunk>(sq >> ChunkBits) + static_cast<Chunk>(lo >> ChunkBits);
+        r[2 * i + 1] = static_cast<Chunk>(hi);
+        carry = static_cast<Chunk>(hi >> ChunkBits);
+    }
+}
+
+// thresholds are in chunks of the smaller operand
+static constexpr std::size_t Toom2Thresh = 24;
+static constexpr std::size_t Toom3Thresh = 96;
+static constexpr std::size_t Toom4Thresh = 300;
+static constexpr std::size_t Toom8Thresh = 1300;
+static constexpr std::size_t Toom32Thresh = 48;
+static constexpr std::size_t Toom42Thresh = 48;
+static constexpr std::size_t NttThresh = 6000;
+// longest cyclic convolution the NTT primes allow with 32 bit chunks, 64 bit
+// chunks have no practical limit
+static constexpr std::size_t NttMaxLength = ChunkBits == 32 ? std::size_t(1) << 25 : static_cast<std::size_t>(-1);
+// below this the doubling and diagonal passes of sqrBasecase cost more than
+// the products they save
+static constexpr std::size_t SqrBasecaseThresh = 10;
+
+enum class MulKind
+{
+    Basecase,
+    Blocks,
+    Toom2,
+    Toom3,
+    Toom4,
+    Toom8,
+    Toom32,
+    Toom42,
+    Ntt,
+};
+
+// an >= bn, the Toom splits need every part of both operands to be non empty.
+// Ratios from 3 up go blockwise, 7/4 to 3 split a in four and b in two, 4/3
+// to 7/4 split a in three and b in two, and the balanced splits take the rest.
+// Large enough products below a ratio of 3 go to the NTT, until they are too
+// long for its primes and a Toom split brings them back in range.
+static MulKind mulKind(const std::size_t an, const std::size_t bn)
+{
+    if (bn < Toom2Thresh)
+        return MulKind::Basecase;
+    if (bn >= NttThresh && an < 3 * bn && an + bn - 1 <= NttMaxLength)
+        return MulKind::Ntt;
+    if (an < 3 * bn && 4 * an >= 7 * bn && bn >= Toom42Thresh)
+        return MulKind::Toom42;
+    if (4 * an < 7 * bn && 3 * an >= 4 * bn && bn >= Toom32Thresh)
+        return MulKind::Toom32;
+    if (bn <= ceilDiv(an, 2))
+        return MulKind::Blocks;
+    if (bn >= Toom8Thresh && bn > 7 * ceilDiv(an, 8))
+        return MulKind::Toom8;
+    if (bn >= Toom4Thresh && bn > 3 * ceilDiv(an, 4))
+        return MulKind::Toom4;
+    if (bn >= Toom3Thresh && bn > 2 * ceilDiv(an, 3))
+        return MulKind::Toom3;
+    return MulKind::Toom2;
+}
+
+static std::size_t mulScratch(const std::size_t an, const std::size_t bn)
+{
+    switch (mulKind(an, bn))
+    {
+    case MulKind::Basecase:
+        return 0;
+    case MulKind::Blocks:
+    {
+        const auto rem = an % bn;
+        return 2 * bn + std::max(mulScratch(bn, bn), rem ? mulScratch(bn, rem) : 0);
+    }
+    case MulKind::Toom2:
+    {
+        const auto n = ceilDiv(an, 2);
+        return 4 * n + 1 + std::max(mulScratch(n, n), mulScratch(an - n, bn - n));
+    }
+    case MulKind::Toom3:
+    {
+        const auto n = ceilDiv(an, 3);
+        return 10 * n + 10 + std::max({mulScratch(n + 1, n + 1), mulScratch(n, n), mulScratch(an - 2 * n, bn - 2 * n)});
+    }
+    case MulKind::Toom4:
+    {
+        const auto n = ceilDiv(an, 4);
+        return 16 * n + 16 + std::max({mulScratch(n + 1, n + 1), mulScratch(n, n), mulScratch(an - 3 * n, bn - 3 * n)});
+    }
+    case MulKind::Toom8:
+    {
+        const auto n = ceilDiv(an, 8);
+        return 32 * n + 32 + std::max({mulScratch(n + 1, n + 1), mulScratch(n, n), mulScratch(an - 7 * n, bn - 7 * n)});
+    }
+    case MulKind::Toom32:
+    {
+        const auto n = std::max(ceilDiv(an, 3), ceilDiv(bn, 2)), s = an - 2 * n, t = bn - n;
+        return 8 * n + 8 + std::max({mulScratch(n + 1, n + 1), mulScratch(n, n), mulScratch(std::max(s, t), std::min(s, t))});
+    }
+    case MulKind::Toom42:
+    {
+        const auto n = std::max(ceilDiv(an, 4), ceilDiv(bn, 2)), s = an - 3 * n, t = bn - n;
+        return 11 * n + 11 + std::max({mulScratch(n + 1, n + 1), mulScratch(n, n), mulScratch(std::max(s, t), std::min(s, t))});
+    }
+    case MulKind::Ntt:
+    {
+        // three residue transforms and the second operand's, the root tables
+        // are cached per thread
+        const auto len = std::bit_ceil(an + bn - 1);
+        return 4 * len;
+    }
+    }
+    return 0;
+}
+
+static void mulRec(Chunk *r, const Chunk *a, std::size_t an, const Chunk *b, std::size_t bn, Chunk *scratch);
+
+// a split in blocks of bn chunks, each multiplied by b
+static void mulBlocks(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
+{
+    std::fill(r, r + an + bn, 0);
+    const auto tmp = scratch, rest = scratch + 2 * bn;
+    for (std::size_t i = 0; i < an; i += bn)
+    {
+        const auto blk = std::min(bn, an - i);
+        if (blk == bn)
+            mulRec(tmp, a + i, blk, b, bn, rest);
+        else
+            mulRec(tmp, b, bn, a + i, blk, rest);
+        addInto(r + i, an + bn - i, tmp, blk + bn);
+    }
+}
+
+// Karatsuba with the middle term from |a0 - a1| * |b0 - b1|, scratch layout:
+// |a0 - a1|, |b0 - b1| later overwritten by the middle term (2n + 1), then
+// their product (2n)
+static void toom2Mul(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
+{
+    const auto n = ceilDiv(an, 2), s = an - n, t = bn - n, rn = an + bn;
+    const auto da = scratch, db = scratch + n, mid = scratch;
+    const auto dProd = scratch + 2 * n + 1, rest = dProd + 2 * n;
+    mulRec(r, a, n, b, n, rest);
+    mulRec(r + 2 * n, a + n, s, b + n, t, rest);
+    const auto aNeg = absDiff(da, a, n, a + n, s);
+    const auto bNeg = absDiff(db, b, n, b + n, t);
+    mulRec(dProd, da, n, db, n, rest);
+    mid[2 * n] = addNM(mid, r, 2 * n, r + 2 * n, s + t);
+    if (aNeg == bNeg)
+        subNM(mid, mid, 2 * n + 1, dProd, 2 * n);
+    else
+        addNM(mid, mid, 2 * n + 1, dProd, 2 * n);
+    addInto(r + n, rn - n, mid, std::min(2 * n + 1, rn - n));
+}
+
+static void sqrRec(Chunk *r, const Chunk *a, std::size_t n, Chunk *scratch);
+
+// toom2Mul with both operands the same, the middle term comes from
+// (a0 - a1)^2 which is never negative, same scratch layout
+static void toom2Sqr(Chunk *r, const Chunk *a, const std::size_t an, Chunk *scratch)
+{
+    const auto n = ceilDiv(an, 2), s = an - n, rn = 2 * an;
+    const auto da = scratch, mid = scratch;
+    const auto dProd = scratch + 2 * n + 1, rest = dProd + 2 * n;
+    sqrRec(r, a, n, rest);
+    sqrRec(r + 2 * n, a + n, s, rest);
+    absDiff(da, a, n, a + n, s);
+    sqrRec(dProd, da, n, rest);
+    mid[2 * n] = addNM(mid, r, 2 * n, r + 2 * n, 2 * s);
+    subNM(mid, mid, 2 * n + 1, dProd, 2 * n);
+    addInto(r + n, rn - n, mid, std::min(2 * n + 1, rn - n));
+}
+
+// p1 = a0 + a1 + a2 and pm1 = |a0 - a1 + a2|, returns whether a0 - a1 + a2 < 0
+static bool toom3Eval(Chunk *p1, Chunk *pm1, const Chunk *a, const std::size_t n, const std::size_t s)
+{
+    p1[n] = addNM(p1, a, n, a + 2 * n, s);
+    const auto neg = absDiff(pm1, p1, n + 1, a + n, n);
+    p1[n] += addN(p1, p1, a + n, n);
+    return neg;
+}
+
+// p2 = a0 + 2 * a1 + 4 * a2
+static void toom3Eval2(Chunk *p2, const Chunk *a, const std::size_t n, const std::size_t s)
+{
+    std::copy(a + 2 * n, a + 2 * n + s, p2);
+    std::fill(p2 + s, p2 + n + 1, 0);
+    lshiftN(p2, p2, n + 1, 1);
+    p2[n] += addN(p2, p2, a + n, n);
+    lshiftN(p2, p2, n + 1, 1);
+    p2[n] += addN(p2, p2, a, n);
+}
+
+// v0 = r and vinf = r + 4n (st chunks) are in place, v1, vm1 and v2 hold the
+// other three products modulo 2^((2n + 2) * ChunkBits)
+static void toom3Interpolate(Chunk *r, const std::size_t rn, const std::size_t n, const std::size_t st, Chunk *v1, Chunk *vm1, Chunk *v2)
+{
+    const auto w = 2 * n + 2;
+    const auto v0 = r, vinf = r + 4 * n;
+    subN(v2, v2, vm1, w);
+    divExactOdd(v2, w, 3);
+    subN(vm1, v1, vm1, w);
+    rshiftN(vm1, vm1, w, 1);
+    subNM(v1, v1, w, v0, 2 * n);
+    subN(v2, v2, v1, w);
+    rshiftN(v2, v2, w, 1);
+    subN(v1, v1, vm1, w);
+    subNM(v1, v1, w, vinf, st);
+    subNM(v2, v2, w, vinf, st);
+    subNM(v2, v2, w, vinf, st);
+    subN(vm1, vm1, v2, w);
+    // vm1, v1 and v2 now hold the coefficients of x^n, x^2n and x^3n
+    std::fill(r + 2 * n, r + 4 * n, 0);
+    addInto(r + n, rn - n, vm1, std::min(w, rn - n));
+    addInto(r + 2 * n, rn - 2 * n, v1, std::min(w, rn - 2 * n));
+    addInto(r + 3 * n, rn - 3 * n, v2, std::min(w, rn - 3 * n));
+}
+
+// Toom-3 evaluated at 0, 1, -1, 2 and infinity. v0 and vinf go straight to r,
+// the other three products live in scratch modulo 2^(w * ChunkBits) where the
+// interpolation only has to deal with vm1 being negative.
+static void toom3Mul(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
+{
+    const auto n = ceilDiv(an, 3), s = an - 2 * n, t = bn - 2 * n, rn = an + bn, w = 2 * n + 2;
+    const auto pa = scratch, pb = pa + n + 1, qa = pb + n + 1, qb = qa + n + 1;
+    const auto v1 = qb + n + 1, vm1 = v1 + w, v2 = vm1 + w, rest = v2 + w;
+    const auto v0 = r, vinf = r + 4 * n;
+    const auto aNeg = toom3Eval(pa, pb, a, n, s);
+    const auto bNeg = toom3Eval(qa, qb, b, n, t);
+    mulRec(v1, pa, n + 1, qa, n + 1, rest);
+    mulRec(vm1, pb, n + 1, qb, n + 1, rest);
+    if (aNeg != bNeg)
+        negateN(vm1, w);
+    toom3Eval2(pa, a, n, s);
+    toom3Eval2(qa, b, n, t);
+    mulRec(v2, pa, n + 1, qa, n + 1, rest);
+    mulRec(v0, a, n, b, n, rest);
+    mulRec(vinf, a + 2 * n, s, b + 2 * n, t, rest);
+    toom3Interpolate(r, rn, n, s + t, v1, vm1, v2);
+}
+
+// Toom-3 squaring, a single evaluation per point and vm1 is never negative
+static void toom3Sqr(Chunk *r, const Chunk *a, const std::size_t an, Chunk *scratch)
+{
+    const auto n = ceilDiv(an, 3), s = an - 2 * n, rn = 2 * an, w = 2 * n + 2;
+    const auto pa = scratch, pb = pa + n + 1;
+    const auto v1 = scratch + 4 * n + 4, vm1 = v1 + w, v2 = vm1 + w, rest = v2 + w;
+    toom3Eval(pa, pb, a, n, s);
+    sqrRec(v1, pa, n + 1, rest);
+    sqrRec(vm1, pb, n + 1, rest);
+    toom3Eval2(pa, a, n, s);
+    sqrRec(v2, pa, n + 1, rest);
+    sqrRec(r, a, n, rest);
+    sqrRec(r + 4 * n, a + 2 * n, s, rest);
+    toom3Interpolate(r, rn, n, 2 * s, v1, vm1, v2);
+}
+
+// x = a + (b << k) with x having n + 1 chunks, a n chunks and b bn <= n chunks
+static void toom4ShiftAdd(Chunk *x, const Chunk *a, const std::size_t n, const Chunk *b, const std::size_t bn, const int k)
+{
+    std::copy(b, b + bn, x);
+    std::fill(x + bn, x + n + 1, 0);
+    if (k)
+        lshiftN(x, x, n + 1, k);
+    x[n] += addN(x, x, a, n);
+}
+
+// pos = a(2^k) and neg = |a(-2^k)| for k = 0 or 1 from the even part
+// a0 + 4^k a2 and the odd part 2^k (a1 + 4^k a3), tmp holds n + 1 chunks.
+// Returns whether a(-2^k) < 0.
+static bool toom4Eval(Chunk *pos, Chunk *neg, const Chunk *a, const std::size_t n, const std::size_t s, const int k, Chunk *tmp)
+{
+    toom4ShiftAdd(pos, a, n, a + 2 * n, n, 2 * k);
+    toom4ShiftAdd(tmp, a + n, n, a + 3 * n, s, 2 * k);
+    if (k)
+        lshiftN(tmp, tmp, n + 1, k);
+    const auto isNeg = absDiff(neg, pos, n + 1, tmp, n + 1);
+    addN(pos, pos, tmp, n + 1);
+    return isNeg;
+}
+
+// ph = 8 * a0 + 4 * a1 + 2 * a2 + a3, which is 8 * a(1/2)
+static void toom4EvalHalf(Chunk *ph, const Chunk *a, const std::size_t n, const std::size_t s)
+{
+    std::copy(a, a + n, ph);
+    ph[n] = 0;
+    for (std::size_t i = 1; i < 3; ++i)
+    {
+        lshiftN(ph, ph, n + 1, 1);
+        ph[n] += addN(ph, ph, a + i * n, n);
+    }
+    lshiftN(ph, ph, n + 1, 1);
+    addInto(ph, n + 1, a + 3 * n, s);
+}
+
+// r -= x << k modulo 2^(w * ChunkBits) for x having xn <= w chunks and any
+// k >= 0, tmp holds w chunks
+static void toom4SubShifted(Chunk *r, const std::size_t w, const Chunk *x, const std::size_t xn, const int k, Chunk *tmp)
+{
+    const auto q = static_cast<std::size_t>(k / ChunkBits);
+    if (q >= w)
+        return;
+    const auto m = w - q, xm = std::min(xn, m);
+    if (k % ChunkBits == 0)
+    {
+        subNM(r + q, r + q, m, x, xm);
+        return;
+    }
+    std::copy(x, x + xm, tmp);
+    std::fill(tmp + xm, tmp + m, 0);
+    lshiftN(tmp, tmp, m, k % ChunkBits);
+    subN(r + q, r + q, tmp, m);
+}
+
+// v0 = r and vinf = r + 6n (st chunks) are in place, v1, vm1, v2, vm2 and vh
+// hold the other five products modulo 2^((2n + 2) * ChunkBits) with vh the
+// product at 1/2 scaled by 64. The even and odd parts at 1 and 2 give r2 and
+// r4 directly, vh then leaves a 3 by 3 system for r1, r3 and r5. Every shift
+// is of a non-negative value, the odd divisions are exact modular ones.
+static void toom4Interpolate(Chunk *r, const std::size_t rn, const std::size_t n, const std::size_t st,
+                             Chunk *v1, Chunk *vm1, Chunk *v2, Chunk *vm2, Chunk *vh, Chunk *tmp)
+{
+    const auto w = 2 * n + 2;
+    const auto v0 = r, vinf = r + 6 * n;
+    // vm1 = r1 + r3 + r5, v1 = r0 + r2 + r4 + r6
+    subN(vm1, v1, vm1, w);
+    rshiftN(vm1, vm1, w, 1);
+    subN(v1, v1, vm1, w);
+    // vm2 = r1 + 4 r3 + 16 r5, v2 = r0 + 4 r2 + 16 r4 + 64 r6
+    subN(vm2, v2, vm2, w);
+    rshiftN(vm2, vm2, w, 2);
+    subN(v2, v2, vm2, w);
+    subN(v2, v2, vm2, w);
+    // v1 = r2 + r4 and v2 = r2 + 4 r4, then v2 = r4 and v1 = r2
+    subNM(v1, v1, w, v0, 2 * n);
+    subNM(v1, v1, w, vinf, st);
+    subNM(v2, v2, w, v0, 2 * n);
+    toom4SubShifted(v2, w, vinf, st, 6, tmp);
+    rshiftN(v2, v2, w, 2);
+    subN(v2, v2, v1, w);
+    divExactOdd(v2, w, 3);
+    subN(v1, v1, v2, w);
+    // vh = 16 r1 + 4 r3 + r5
+    toom4SubShifted(vh, w, v0, 2 * n, 6, tmp);
+    subNM(vh, vh, w, vinf, st);
+    toom4SubShifted(vh, w, v1, w, 4, tmp);
+    toom4SubShifted(vh, w, v2, w, 2, tmp);
+    rshiftN(vh, vh, w, 1);
+    // vh = 5 r1 + r3 and vm2 = r3 + 5 r5
+    subN(vh, vh, vm1, w);
+    divExactOdd(vh, w, 3);
+    subN(vm2, vm2, vm1, w);
+    divExactOdd(vm2, w, 3);
+    // tmp = r3, vh = r1 - r5 and vm1 = r1 + r5
+    mul1(tmp, vm1, w, 5);
+    subN(tmp, tmp, vh, w);
+    subN(tmp, tmp, vm2, w);
+    divExactOdd(tmp, w, 3);
+    subN(vh, vh, vm2, w);
+    divExactOdd(vh, w, 5);
+    subN(vm1, vm1, tmp, w);
+    // vm2 = r1 and vm1 = r5
+    addN(vm2, vm1, vh, w);
+    rshiftN(vm2, vm2, w, 1);
+    subN(vm1, vm1, vm2, w);
+    std::fill(r + 2 * n, r + 6 * n, 0);
+    const Chunk *coeffs[] = {vm2, v1, tmp, v2, vm1};
+    for (std::size_t i = 1; i <= 5; ++i)
+    {
+        addInto(r + i * n, rn - i * n, coeffs[i - 1], std::min(w, rn - i * n));
+    }
+}
+
+// Toom-4 evaluated at 0, 1, -1, 2, -2, 1/2 and infinity, laid out like
+// toom3Mul: the four evaluations of the current point pair and a temporary,
+// then the five products that do not go straight to r
+static void toom4Mul(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
+{
+    const auto n = ceilDiv(an, 4), s = an - 3 * n, t = bn - 3 * n, rn = an + bn, w = 2 * n + 2;
+    const auto pa = scratch, pb = pa + n + 1, qa = pb + n + 1, qb = qa + n + 1, tmp = qb + n + 1;
+    const auto v1 = tmp + w, vm1 = v1 + w, v2 = vm1 + w, vm2 = v2 + w, vh = vm2 + w, rest = vh + w;
+    for (int k = 0; k < 2; ++k)
+    {
+        const auto vPos = k ? v2 : v1, vNeg = k ? vm2 : vm1;
+        const auto aNeg = toom4Eval(pa, pb, a, n, s, k, tmp);
+        const auto bNeg = toom4Eval(qa, qb, b, n, t, k, tmp);
+        mulRec(vPos, pa, n + 1, qa, n + 1, rest);
+        mulRec(vNeg, pb, n + 1, qb, n + 1, rest);
+        if (aNeg != bNeg)
+            negateN(vNeg, w);
+    }
+    toom4EvalHalf(pa, a, n, s);
+    toom4EvalHalf(qa, b, n, t);
+    mulRec(vh, pa, n + 1, qa, n + 1, rest);
+    mulRec(r, a, n, b, n, rest);
+    mulRec(r + 6 * n, a + 3 * n, s, b + 3 * n, t, rest);
+    toom4Interpolate(r, rn, n, s + t, v1, vm1, v2, vm2, vh, tmp);
+}
+
+// Toom-4 squaring, a single evaluation per point in the toom4Mul layout
+static void toom4Sqr(Chunk *r, const Chunk *a, const std::size_t an, Chunk *scratch)
+{
+    const auto n = ceilDiv(an, 4), s = an - 3 * n, rn = 2 * an, w = 2 * n + 2;
+    const auto pa = scratch, pb = pa + n + 1, tmp = scratch + 4 * n + 4;
+    const auto v1 = tmp + w, vm1 = v1 + w, v2 = vm1 + w, vm2 = v2 + w, vh = vm2 + w, rest = vh + w;
+    for (int k = 0; k < 2; ++k)
+    {
+        toom4Eval(pa, pb, a, n, s, k, tmp);
+        sqrRec(k ? v2 : v1, pa, n + 1, rest);
+        sqrRec(k ? vm2 : vm1, pb, n + 1, rest);
+    }
+    toom4EvalHalf(pa, a, n, s);
+    sqrRec(vh, pa, n + 1, rest);
+    sqrRec(r, a, n, rest);
+    sqrRec(r + 6 * n, a + 3 * n, s, rest);
+    toom4Interpolate(r, rn, n, 2 * s, v1, vm1, v2, vm2, vh, tmp);
+}
+
+// mulRec for the top parts of the unbalanced splits, which come in either order
+static void mulRecAny(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
+{
+    if (an < bn)
+        return mulRec(r, b, bn, a, an, scratch);
+    mulRec(r, a, an, b, bn, scratch);
+}
+
+// Toom-32 for a about 3/2 the length of b, a split in three parts and b in
+// two of n chunks each, evaluated at 0, 1, -1 and infinity. The odd and even
+// parts of v1 and vm1 give the two middle coefficients directly.
+static void toom32Mul(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
+{
+    const auto n = std::max(ceilDiv(an, 3), ceilDiv(bn, 2)), s = an - 2 * n, t = bn - n, rn = an + bn, w = 2 * n + 2;
+    const auto pa = scratch, pb = pa + n + 1, qa = pb + n + 1, qb = qa + n + 1;
+    const auto v1 = qb + n + 1, vm1 = v1 + w, rest = vm1 + w;
+    const auto v0 = r, vinf = r + 3 * n;
+    const auto aNeg = toom3Eval(pa, pb, a, n, s);
+    qa[n] = addNM(qa, b, n, b + n, t);
+    const auto bNeg = absDiff(qb, b, n, b + n, t);
+    qb[n] = 0;
+    mulRec(v1, pa, n + 1, qa, n + 1, rest);
+    mulRec(vm1, pb, n + 1, qb, n + 1, rest);
+    if (aNeg != bNeg)
+        negateN(vm1, w);
+    mulRec(v0, a, n, b, n, rest);
+    mulRecAny(vinf, a + 2 * n, s, b + n, t, rest);
+    // vm1 = r1 + r3 and v1 = r0 + r2, then the coefficients of x^n and x^2n
+    subN(vm1, v1, vm1, w);
+    rshiftN(vm1, vm1, w, 1);
+    subN(v1, v1, vm1, w);
+    subNM(v1, v1, w, v0, 2 * n);
+    subNM(vm1, vm1, w, vinf, s + t);
+    std::fill(r + 2 * n, r + 3 * n, 0);
+    addInto(r + n, rn - n, vm1, std::min(w, rn - n));
+    addInto(r + 2 * n, rn - 2 * n, v1, std::min(w, rn - 2 * n));
+}
+
+// Toom-42 for a about twice the length of b, a split in four parts and b in
+// two of n chunks each. The product has the degree of a Toom-3 one, so it is
+// evaluated at the same points and shares toom3Interpolate.
+static void toom42Mul(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
+{
+    const auto n = std::max(ceilDiv(an, 4), ceilDiv(bn, 2)), s = an - 3 * n, t = bn - n, rn = an + bn, w = 2 * n + 2;
+    const auto pa = scratch, pb = pa + n + 1, qa = pb + n + 1, qb = qa + n + 1, tmp = qb + n + 1;
+    const auto v1 = tmp + n + 1, vm1 = v1 + w, v2 = vm1 + w, rest = v2 + w;
+    const auto aNeg = toom4Eval(pa, pb, a, n, s, 0, tmp);
+    qa[n] = addNM(qa, b, n, b + n, t);
+    const auto bNeg = absDiff(qb, b, n, b + n, t);
+    qb[n] = 0;
+    mulRec(v1, pa, n + 1, qa, n + 1, rest);
+    mulRec(vm1, pb, n + 1, qb, n + 1, rest);
+    if (aNeg != bNeg)
+        negateN(vm1, w);
+    toom4Eval(pa, pb, a, n, s, 1, tmp);
+    toom4ShiftAdd(qa, b, n, b + n, t, 1);
+    mulRec(v2, pa, n + 1, qa, n + 1, rest);
+    mulRec(r, a, n, b, n, rest);
+    mulRecAny(r + 4 * n, a + 3 * n, s, b + n, t, rest);
+    toom3Interpolate(r, rn, n, s + t, v1, vm1, v2);
+}
+
+// r >>= s for a two's complement value of n chunks, 0 < s < ChunkBits
+static void rshiftSigned(Chunk *r, const std::size_t n, const int s)
+{
+    const Chunk sign = 0 - (r[n - 1] >> (ChunkBits - 1));
+    rshiftN(r, r, n, s);
+    r[n - 1] |= sign << (ChunkBits - s);
+}
+
+// Steps solving N rows of w chunks for N unknowns, worked out at compile time
+// from the small integer coefficients of the unknowns in each row. Gaussian
+// elimination down and back up keeps every row integral: a row is scaled by
+// the pivot's coefficient over their gcd before the pivot is subtracted, then
+// divided by the gcd of its own coefficients. The rows are two's complement
+// values modulo 2^(w * ChunkBits) from then on.
+template <std::size_t N>
+struct ToomPlan
+{
+    enum class Op : std::uint8_t
+    {
+        Scale,
+        SubMul,
+        Div,
+    };
+    struct Step
+    {
+        Op op;
+        std::uint8_t dst, src;
+        std::int64_t c;
+    };
+    using Rows = std::array<std::array<std::int64_t, N>, N>;
+
+    std::array<Step, 3 * N * N> steps{};
+    std::size_t size = 0;
+    // row holding each unknown at the end
+    std::array<std::uint8_t, N> row{};
+    // bits of the largest coefficient sum a row reaches
+    int bits = 0;
+    // largest multiplier or odd divisor of a step
+    std::int64_t maxConst = 0;
+
+    constexpr explicit ToomPlan(Rows m)
+    {
+        for (const auto &r : m)
+        {
+            std::int64_t sum = 0;
+            for (const auto c : r)
+            {
+                sum += c;
+            }
+            note(sum, 1);
+        }
+        // the unknowns go from the middle out, which keeps the multipliers
+        // within a chunk
+        std::array<std::size_t, N> order{};
+        std::array<bool, N> used{};
+        const auto dist = [](const std::size_t j)
+        { return abs(2 * static_cast<std::int64_t>(j) - static_cast<std::int64_t>(N - 1)); };
+        for (auto &v : order)
+        {
+            v = N;
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                if (!used[j] && (v == N || dist(j) < dist(v)))
+                    v = j;
+            }
+            used[v] = true;
+        }
+        used = {};
+        for (const auto v : order)
+        {
+            std::size_t p = N;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (!used[i] && m[i][v] && (p == N || abs(m[i][v]) < abs(m[p][v])))
+                    p = i;
+            }
+            used[p] = true;
+            row[v] = static_cast<std::uint8_t>(p);
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (!used[i] && m[i][v])
+                    eliminate(m, i, p, v);
+            }
+        }
+        for (auto t = N; t--;)
+        {
+            for (std::size_t u = 0; u < t; ++u)
+            {
+                if (m[row[order[u]]][order[t]])
+                    eliminate(m, row[order[u]], row[order[t]], order[t]);
+            }
+        }
+        for (std::size_t v = 0; v < N; ++v)
+        {
+            if (m[row[v]][v] != 1)
+                div(row[v], m[row[v]][v]);
+        }
+    }
+
+    constexpr void note(const std::int64_t sum, const std::int64_t c)
+    {
+        bits = std::max(bits, static_cast<int>(std::bit_width(static_cast<std::uint64_t>(sum))));
+        maxConst = std::max(maxConst, c);
+    }
+
+    constexpr void div(const std::size_t i, const std::int64_t d)
+    {
+        steps[size++] = {Op::Div, static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i), d};
+        auto odd = abs(d);
+        while (odd % 2 == 0)
+            odd /= 2;
+        note(0, odd);
+    }
+
+    static constexpr std::int64_t abs(const std::int64_t x) { return x < 0 ? -x : x; }
+
+    constexpr void eliminate(Rows &m, const std::size_t i, const std::size_t p, const std::size_t v)
+    {
+        const auto g = std::gcd(m[p][v], m[i][v]);
+        auto a = m[p][v] / g, b = m[i][v] / g;
+        if (a < 0)
+            a = -a, b = -b;
+        if (a != 1)
+            steps[size++] = {Op::Scale, static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i), a};
+        steps[size++] = {Op::SubMul, static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(p), b};
+        std::int64_t d = 0, scaled = 0, sum = 0;
+        for (std::size_t u = 0; u < N; ++u)
+        {
+            scaled += abs(m[i][u]) * a;
+            m[i][u] = m[i][u] * a - m[p][u] * b;
+            d = std::gcd(d, m[i][u]);
+            sum += abs(m[i][u]);
+        }
+        note(std::max(scaled, sum), std::max(a, abs(b)));
+        if (d > 1)
+        {
+            div(i, d);
+            for (std::size_t u = 0; u < N; ++u)
+            {
+                m[i][u] /= d;
+            }
+        }
+    }
+};
+
+// runs plan on rows of w chunks
+template <std::size_t N>
+static void toomSolve(const ToomPlan<N> &plan, const std::array<Chunk *, N> &rows, const std::size_t w)
+{
+    using Op = typename ToomPlan<N>::Op;
+    for (std::size_t i = 0; i < plan.size; ++i)
+    {
+        const auto &step = plan.steps[i];
+        const auto r = rows[step.dst];
+        const auto c = static_cast<Chunk>(step.c < 0 ? -step.c : step.c);
+        switch (step.op)
+        {
+        case Op::Scale:
+            mul1(r, r, w, c);
+            break;
+        case Op::SubMul:
+            if (step.c < 0)
+                addMul1(r, rows[step.src], w, c);
+            else
+                subMul1(r, rows[step.src], w, c);
+            break;
+        case Op::Div:
+            if (const auto s = std::countr_zero(c))
+                rshiftSigned(r, w, s);
+            if (c >> std::countr_zero(c) != 1)
+                divExactOdd(r, w, c >> std::countr_zero(c));
+            if (step.c < 0)
+                negateN(r, w);
+            break;
+        }
+    }
+}
+
+// Toom-8 evaluates at 0, infinity, the pairs +-2^k for k = 0 to 3, the pairs
+// +-2^-k for k = 1 and 2, and 2^-3 alone. A point 2^-k is the reversed pieces
+// at 2^k, which is the value at 2^-k scaled by 2^(7k).
+struct Toom8Point
+{
+    int k;
+    bool rev;
+};
+static constexpr Toom8Point Toom8Points[] = {{0, false}, {1, false}, {2, false}, {3, false}, {1, true}, {2, true}, {3, true}};
+
+// Once the pairs are split in even and odd parts and cleared of v0 and vinf,
+// the row of a point holds the N even or odd coefficients times 4^(k j) for
+// the j-th one, counted from the top for a reversed point
+template <std::size_t N>
+static constexpr ToomPlan<N> toom8Plan()
+{
+    typename ToomPlan<N>::Rows m{};
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = 0; j < N; ++j)
+        {
+            m[i][j] = std::int64_t(1) << 2 * Toom8Points[i].k * (Toom8Points[i].rev ? N - 1 - j : j);
+        }
+    }
+    return ToomPlan<N>(m);
+}
+// the even system leaves out the lone point, the odd one takes all of them
+static constexpr auto Toom8EvenPlan = toom8Plan<6>();
+static constexpr auto Toom8OddPlan = toom8Plan<7>();
+// each coefficient is below 2^(2n * ChunkBits + 3), so a row stays below
+// 2^bits times that and has to fit with its sign in the two chunks of
+// headroom. The steps take their constants as single chunks.
+static_assert(Toom8EvenPlan.bits + 4 < 2 * ChunkBits && Toom8OddPlan.bits + 4 < 2 * ChunkBits);
+static_assert(Toom8EvenPlan.maxConst <= static_cast<Chunk>(-1) && Toom8OddPlan.maxConst <= static_cast<Chunk>(-1));
+
+// x = sum of the pieces first, first + step, ... of a, the i-th of them times
+// 2^(shift i), by Horner from the top. With rev the pieces count from the top.
+static void toom8Horner(Chunk *x, const Chunk *a, const std::size_t n, const std::size_t s, const int first, const int step, const int shift, const bool rev)
+{
+    std::fill(x, x + n + 1, 0);
+    for (auto i = 7 - (7 - first) % step; i >= first; i -= step)
+    {
+        if (shift)
+            lshiftN(x, x, n + 1, shift);
+        const auto p = static_cast<std::size_t>(rev ? 7 - i : i);
+        addInto(x, n + 1, a + p * n, p == 7 ? s : n);
+    }
+}
+
+// pos and neg = |value at -x| for the point x from the even and odd parts,
+// tmp holds n + 1 chunks. Returns whether the value at -x is negative.
+static bool toom8Eval(Chunk *pos, Chunk *neg, const Chunk *a, const std::size_t n, const std::size_t s, const Toom8Point pt, Chunk *tmp)
+{
+    toom8Horner(pos, a, n, s, 0, 2, 2 * pt.k, pt.rev);
+    toom8Horner(tmp, a, n, s, 1, 2, 2 * pt.k, pt.rev);
+    if (pt.k)
+        lshiftN(tmp, tmp, n + 1, pt.k);
+    const auto isNeg = absDiff(neg, pos, n + 1, tmp, n + 1);
+    addN(pos, pos, tmp, n + 1);
+    return isNeg;
+}
+
+// v0 = r and vinf = r + 14n (st chunks) are in place, vp[i] and vm[i] hold
+// the products at the i-th point and its negation modulo 2^((2n + 2) *
+// ChunkBits), vp[6] the one at 2^-3. Each pair leaves its even part in vp[i]
+// and its odd part in vm[i], both non-negative. Clearing v0 and vinf from the
+// even parts gives the rows of the even plan, whose solution clears vp[6] to
+// the last row of the odd plan.
+static void toom8Interpolate(Chunk *r, const std::size_t rn, const std::size_t n, const std::size_t st,
+                             const std::array<Chunk *, 7> &vp, const std::array<Chunk *, 7> &vm, Chunk *tmp)
+{
+    const auto w = 2 * n + 2;
+    const auto v0 = r, vinf = r + 14 * n;
+    for (std::size_t i = 0; i < 6; ++i)
     {
-        auto chunk = chunks[i];
-        auto &hexChunk = hexChunks[i];
-        for (std::size_t j = hexChunk.size(); j-- && chunk;)
+        const auto [k, rev] = Toom8Points[i];
+        subN(vm[i], vp[i], vm[i], w);
+        rshiftN(vm[i], vm[i], w, 1);
+        subN(vp[i], vp[i], vm[i], w);
+        toom4SubShifted(vp[i], w, v0, 2 * n, rev ? 14 * k : 0, tmp);
+        toom4SubShifted(vp[i], w, vinf, st, rev ? 0 : 14 * k, tmp);
+        if (k)
         {
-            auto off = chunk % 16;
-            chunk /= 16;
-            hexChunk[j] = static_cast<char>(off < 10 ? '0' + off
-                                                     : 'a' + off - 10);
+            rshiftN(vp[i], vp[i], w, 2 * k);
+            rshiftN(vm[i], vm[i], w, k);
         }
     }
-    auto &lastHexChunk = hexChunks.back();
-    lastHexChunk = lastHexChunk.substr(lastHexChunk.find_first_not_of('0'));
-    for (std::size_t i = hexChunks.size(); i--;)
+    const std::array<Chunk *, 6> even{vp[0], vp[1], vp[2], vp[3], vp[4], vp[5]};
+    toomSolve(Toom8EvenPlan, even, w);
+    // vp[6] is the sum of the coefficients i times 8^(14 - i)
+    toom4SubShifted(vp[6], w, v0, 2 * n, 42, tmp);
+    subNM(vp[6], vp[6], w, vinf, st);
+    for (std::size_t j = 0; j < 6; ++j)
     {
-        res += hexChunks[i];
+        toom4SubShifted(vp[6], w, even[Toom8EvenPlan.row[j]], w, static_cast<int>(3 * (12 - 2 * j)), tmp);
+    }
+    rshiftN(vp[6], vp[6], w, 3);
+    const std::array<Chunk *, 7> odd{vm[0], vm[1], vm[2], vm[3], vm[4], vm[5], vp[6]};
+    toomSolve(Toom8OddPlan, odd, w);
+    std::fill(r + 2 * n, r + 14 * n, 0);
+    for (std::size_t i = 1; i <= 13; ++i)
+    {
+        const auto c = i % 2 ? odd[Toom8OddPlan.row[i / 2]] : even[Toom8EvenPlan.row[i / 2 - 1]];
+        addInto(r + i * n, rn - i * n, c, std::min(w, rn - i * n));
     }
-    return res;
 }
 
-BigInt BigInt::fromString(std::string_view str)
+// Toom-8 laid out like toom4Mul: the four evaluations of the current point
+// and a temporary, then the thirteen products that do not go straight to r
+static void toom8Mul(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
 {
-    constexpr auto exceptionMsg = "BigInt fromString has invalid argument";
-    bool strIsNeg = str.size() && str[0] == '-';
-    if (strIsNeg)
-        str.remove_prefix(1);
-    if (str.size() == 0)
-        throw std::invalid_argument(exceptionMsg);
-    BigInt res;
-    while (str.size())
+    const auto n = ceilDiv(an, 8), s = an - 7 * n, t = bn - 7 * n, rn = an + bn, w = 2 * n + 2;
+    const auto pa = scratch, pb = pa + n + 1, qa = pb + n + 1, qb = qa + n + 1, tmp = qb + n + 1;
+    std::array<Chunk *, 7> vp, vm;
+    for (std::size_t i = 0; i < 7; ++i)
     {
-        res *= TenQuintillion();
-        auto sub = str.substr(0, str.size() % 19 == 0 ? 19 : str.size() % 19);
-        std::uint64_t tmp;
-        auto fcRes = std::from_chars(sub.data(), sub.data() + sub.size(), tmp);
-        if (fcRes.ec != std::errc{} || fcRes.ptr != sub.data() + sub.size())
-            throw std::invalid_argument(exceptionMsg);
-        res.chunks.resize(std::max<std::size_t>(res.chunks.size() + 1, 3));
-        if (tmp)
-            addChunk(res.chunks, 0, static_cast<std::uint32_t>(tmp));
-        if (tmp >> 32)
-            addChunk(res.chunks, 1, static_cast<std::uint32_t>(tmp >> 32));
-        res.normalize();
-        str.remove_prefix(sub.size());
+        vp[i] = tmp + (2 * i + 1) * w;
+        vm[i] = vp[i] + w;
     }
-    if (strIsNeg)
-        res.negate();
-    return res;
+    const auto rest = vp[6] + w;
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        const auto aNeg = toom8Eval(pa, pb, a, n, s, Toom8Points[i], tmp);
+        const auto bNeg = toom8Eval(qa, qb, b, n, t, Toom8Points[i], tmp);
+        mulRec(vp[i], pa, n + 1, qa, n + 1, rest);
+        mulRec(vm[i], pb, n + 1, qb, n + 1, rest);
+        if (aNeg != bNeg)
+            negateN(vm[i], w);
+    }
+    toom8Horner(pa, a, n, s, 0, 1, 3, true);
+    toom8Horner(qa, b, n, t, 0, 1, 3, true);
+    mulRec(vp[6], pa, n + 1, qa, n + 1, rest);
+    mulRec(r, a, n, b, n, rest);
+    mulRec(r + 14 * n, a + 7 * n, s, b + 7 * n, t, rest);
+    toom8Interpolate(r, rn, n, s + t, vp, vm, tmp);
 }
 
-BigInt BigInt::fromHex(std::string_view str)
+// Toom-8 squaring, a single evaluation per point in the toom8Mul layout
+static void toom8Sqr(Chunk *r, const Chunk *a, const std::size_t an, Chunk *scratch)
 {
-    constexpr auto exceptionMsg = "BigInt fromHex has invalid argument";
-    bool strIsNeg = str.substr(0, 3) == "-0x"  ? true
-                    : str.substr(0, 2) == "0x" ? false
-                                               : throw std::invalid_argument(exceptionMsg);
-    str.remove_prefix(strIsNeg ? 3 : 2);
-    if (str.size() == 0)
-        throw std::invalid_argument(exceptionMsg);
-    BigInt res;
-    res.chunks.resize(ceilDiv(str.size(), 8));
-    for (auto &chunk : res.chunks)
+    const auto n = ceilDiv(an, 8), s = an - 7 * n, rn = 2 * an, w = 2 * n + 2;
+    const auto pa = scratch, pb = pa + n + 1, tmp = scratch + 4 * n + 4;
+    std::array<Chunk *, 7> vp, vm;
+    for (std::size_t i = 0; i < 7; ++i)
     {
-        auto sub = str.substr(str.size() > 8 ? str.size() - 8 : 0);
-        str.remove_suffix(sub.size());
-        auto fcRes = std::from_chars(sub.data(), sub.data() + sub.size(), chunk, 16);
-        if (fcRes.ec != std::errc{} || fcRes.ptr != sub.data() + sub.size())
-            throw std::invalid_argument(exceptionMsg);
+        vp[i] = tmp + (2 * i + 1) * w;
+        vm[i] = vp[i] + w;
     }
-    res.normalize();
-    if (strIsNeg)
-        res.negate();
-    return res;
+    const auto rest = vp[6] + w;
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        toom8Eval(pa, pb, a, n, s, Toom8Points[i], tmp);
+        sqrRec(vp[i], pa, n + 1, rest);
+        sqrRec(vm[i], pb, n + 1, rest);
+    }
+    toom8Horner(pa, a, n, s, 0, 1, 3, true);
+    sqrRec(vp[6], pa, n + 1, rest);
+    sqrRec(r, a, n, rest);
+    sqrRec(r + 14 * n, a + 7 * n, s, rest);
+    toom8Interpolate(r, rn, n, 2 * s, vp, vm, tmp);
 }
 
-static int mostSigBit(std::uint32_t x)
+// Arithmetic modulo a prime P < 2^(ChunkBits - 1) in Montgomery form with
+// R = 2^ChunkBits, the values stay in [0, P)
+template <Chunk P>
+struct NttField
 {
-    if (x == 0)
-        return 0;
-    int acc = 1;
-    for (int s = 16; s > 0; s /= 2)
+    static constexpr Chunk pInv = 0 - chunkInverse(P);
+    static constexpr Chunk rModP = static_cast<Chunk>((static_cast<DoubleChunk>(1) << ChunkBits) % P);
+    static constexpr Chunk r2 = static_cast<Chunk>(static_cast<DoubleChunk>(rModP) * rModP % P);
+
+    // a * b / R
+    static constexpr Chunk mul(const Chunk a, const Chunk b)
+    {
+        const auto t = static_cast<DoubleChunk>(a) * b;
+        const Chunk m = static_cast<Chunk>(t) * pInv;
+        const auto r = static_cast<Chunk>((t + static_cast<DoubleChunk>(m) * P) >> ChunkBits);
+        return std::min(r, static_cast<Chunk>(r - P));
+    }
+    // r - P wraps around exactly when r < P, so the min keeps the loops
+    // free of branches
+    static constexpr Chunk add(const Chunk a, const Chunk b)
+    {
+        const Chunk r = a + b;
+        return std::min(r, static_cast<Chunk>(r - P));
+    }
+    static constexpr Chunk sub(const Chunk a, const Chunk b)
+    {
+        const Chunk r = a - b;
+        return std::min(r, static_cast<Chunk>(r + P));
+    }
+    static constexpr Chunk toMont(const Chunk a) { return mul(a, r2); }
+    static constexpr Chunk pow(Chunk base, Chunk exp)
     {
-        if (x >> s)
+        auto res = rModP;
+        for (; exp; exp >>= 1)
         {
-            x >>= s;
-            acc += s;
+            if (exp & 1)
+                res = mul(res, base);
+            base = mul(base, base);
         }
+        return res;
     }
-    return acc;
-}
+};
 
-static bool divmodMulSub(BigInt &u, const BigInt &v, const std::size_t j, const std::uint32_t qhat)
-{
-    bool hasBorrow = false;
-    for (std::size_t i = 0; i < v.chunks.size(); ++i)
+// three primes c * 2^k + 1 just below 2^(ChunkBits - 1) with their primitive
+// roots. Their product is above 2^(2 * ChunkBits) times the longest
+// convolution the smallest k allows, so its coefficients are recovered
+// exactly.
+#ifdef BIGINT_CHUNK64
+static constexpr Chunk NttP0 = 7097673012735901697, NttG0 = 3;
+static constexpr Chunk NttP1 = 6269010681299730433, NttG1 = 5;
+static constexpr Chunk NttP2 = 4179340454199820289, NttG2 = 3;
+#else
+static constexpr Chunk NttP0 = 2113929217, NttG0 = 5;
+static constexpr Chunk NttP1 = 2013265921, NttG1 = 31;
+static constexpr Chunk NttP2 = 1811939329, NttG2 = 13;
+#endif
+
+// decimation in frequency, natural order in and bit reversed order out.
+// roots[h + j] = w^j for w of order 2h, in Montgomery form.
+template <Chunk P>
+static void nttForward(Chunk *x, const std::size_t len, const Chunk *roots)
+{
+    using F = NttField<P>;
+    for (auto half = len / 2; half; half /= 2)
     {
-        auto x = static_cast<std::uint64_t>(v.chunks[i]) * qhat;
-        if (x && subChunk(u.chunks, i + j, static_cast<std::uint32_t>(x)))
-            hasBorrow = true;
-        x >>= 32;
-        if (x && subChunk(u.chunks, i + j + 1, static_cast<std::uint32_t>(x)))
-            hasBorrow = true;
+        for (std::size_t i = 0; i < len; i += 2 * half)
+        {
+            for (std::size_t j = 0; j < half; ++j)
+            {
+                const auto u = x[i + j], v = x[i + j + half];
+                x[i + j] = F::add(u, v);
+                x[i + j + half] = F::mul(F::sub(u, v), roots[half + j]);
+            }
+        }
     }
-    return hasBorrow;
 }
 
-static bool divmodAddBack(BigInt &u, const BigInt &v, std::size_t j)
+// decimation in time, bit reversed order in and natural order out, scaled by
+// len. iroots is laid out like roots with the inverse roots.
+template <Chunk P>
+static void nttInverse(Chunk *x, const std::size_t len, const Chunk *iroots)
 {
-    bool hasCarry = false;
-    for (std::size_t i = 0; i < v.chunks.size(); ++i)
+    using F = NttField<P>;
+    for (std::size_t half = 1; half < len; half *= 2)
     {
-        if (v.chunks[i] && addChunk(u.chunks, i + j, v.chunks[i]))
-            hasCarry = true;
+        for (std::size_t i = 0; i < len; i += 2 * half)
+        {
+            for (std::size_t j = 0; j < half; ++j)
+            {
+                const auto u = x[i + j], v = F::mul(x[i + j + half], iroots[half + j]);
+                x[i + j] = F::add(u, v);
+                x[i + j + half] = F::sub(u, v);
+            }
+        }
     }
-    return hasCarry;
 }
 
-DivModRes BigInt::divmod(const BigInt &lhs, const BigInt &rhs) { return divmod(BigInt(lhs), BigInt(rhs)); }
-DivModRes BigInt::divmod(const BigInt &lhs, BigInt &&rhs) { return divmod(BigInt(lhs), std::move(rhs)); }
-DivModRes BigInt::divmod(BigInt &&lhs, const BigInt &rhs) { return divmod(std::move(lhs), BigInt(rhs)); }
-
-DivModRes BigInt::divmod(BigInt &&lhs, BigInt &&rhs)
+// roots[h + j] = w^j for every power of two from <= h < len and w of order 2h
+template <Chunk P, Chunk G>
+static void nttRoots(Chunk *roots, const std::size_t from, const std::size_t len, const bool inverse)
 {
-    if (rhs == Zero())
-        throw std::invalid_argument("BigInt divmod rhs is zero");
-    DivModRes res{{}, std::move(lhs)};
-    res.q.isNeg = res.r.isNeg != rhs.isNeg;
-    const auto d = 32 - mostSigBit(rhs.chunks.back());
-    const auto v = std::move(rhs <<= d);
-    res.r <<= d;
-    const auto v1 = v.chunks.size() >= 1 ? v.chunks[v.chunks.size() - 1] : 0;
-    const auto v2 = v.chunks.size() >= 2 ? v.chunks[v.chunks.size() - 2] : 0;
-    const auto n = v.chunks.size();
-    if (res.r.chunks.size() + 1 > n)
-        res.q.chunks.resize(res.r.chunks.size() + 1 - n);
-    for (std::size_t j = res.q.chunks.size(); j--;)
-    {
-        std::uint64_t uu = res.r.chunks[j + n - 1];
-        if (j + n < res.r.chunks.size())
-            uu |= static_cast<std::uint64_t>(res.r.chunks[j + n]) << 32;
-        std::uint64_t qhat = uu / v1;
-        std::uint64_t rhat = uu % v1;
-        auto u2 = j + n >= 2 ? res.r.chunks[j + n - 2] : 0;
-        while (qhat >> 32 || qhat * v2 > (rhat << 32 | u2))
+    using F = NttField<P>;
+    for (auto h = from; h < len; h *= 2)
+    {
+        const auto e = (P - 1) / (2 * h);
+        const auto w = F::pow(F::toMont(G), inverse ? P - 1 - e : e);
+        roots[h] = F::rModP;
+        for (std::size_t j = 1; j < h; ++j)
         {
-            --qhat;
-            rhat += v1;
-            if (rhat >> 32)
-                break;
+            roots[h + j] = F::mul(roots[h + j - 1], w);
         }
-        if (qhat == 0)
-            continue;
-        if (divmodMulSub(res.r, v, j, static_cast<std::uint32_t>(qhat)))
-            do
-                --qhat;
-            while (!divmodAddBack(res.r, v, j));
-        res.r.normalize();
-        res.q.chunks[j] = static_cast<std::uint32_t>(qhat);
     }
-    res.q.normalize();
-    res.r >>= d;
-    return res;
 }
 
-BigInt BigInt::pow(const BigInt &base, std::int64_t exp)
+// The root tables of P, kept per thread. Every level h sits at the same
+// place whatever the transform length, so the tables only grow by the
+// missing levels when a longer transform comes up.
+template <Chunk P, Chunk G>
+struct NttRootTables
 {
-    if (exp < 0)
-        throw std::invalid_argument("BigInt pow has negative exponent");
-    if (exp == 0)
-        return One();
-    auto x = base;
-    auto y = One();
-    while (exp > 1)
+    std::vector<Chunk> roots, iroots;
+
+    static const NttRootTables &get(const std::size_t len)
     {
-        if (exp % 2)
+        static thread_local NttRootTables tables;
+        const auto from = std::max<std::size_t>(tables.roots.size(), 1);
+        if (from < len)
         {
-            y *= x;
-            --exp;
+            tables.roots.resize(len);
+            tables.iroots.resize(len);
+            nttRoots<P, G>(tables.roots.data(), from, len, false);
+            nttRoots<P, G>(tables.iroots.data(), from, len, true);
         }
-        x *= x;
-        exp /= 2;
+        return tables;
     }
-    return x * y;
-}
+};
 
-BigInt operator+(const BigInt &lhs, const BigInt &rhs)
-{
-    if (rhs.chunks.size() > lhs.chunks.size())
+// x = a * b modulo P as a cyclic convolution of len chunks, y holds len
+// chunks of scratch. A square transforms a once.
+template <Chunk P, Chunk G>
+static void nttConvolve(Chunk *x, const std::size_t len, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *y)
+{
+    using F = NttField<P>;
+    const auto &tables = NttRootTables<P, G>::get(len);
+    const auto roots = tables.roots.data(), iroots = tables.iroots.data();
+    std::transform(a, a + an, x, [](Chunk c)
+                   { return c % P; });
+    std::fill(x + an, x + len, 0);
+    nttForward<P>(x, len, roots);
+    if (a == b && an == bn)
+        y = x;
+    else
     {
-        auto res = rhs;
-        res += lhs;
-        return res;
+        std::transform(b, b + bn, y, [](Chunk c)
+                       { return c % P; });
+        std::fill(y + bn, y + len, 0);
+        nttForward<P>(y, len, roots);
+    }
+    for (std::size_t i = 0; i < len; ++i)
+    {
+        x[i] = F::mul(x[i], y[i]);
+    }
+    nttInverse<P>(x, len, iroots);
+    // the pointwise products left a factor 1 / R and the inverse one of len
+    const auto scale = F::toMont(F::toMont(P - (P - 1) / len));
+    for (std::size_t i = 0; i < len; ++i)
+    {
+        x[i] = F::mul(x[i], scale);
     }
-    auto res = lhs;
-    res += rhs;
-    return res;
 }
 
-BigInt operator+(const BigInt &lhs, BigInt &&rhs) { return std::move(rhs += lhs); }
-BigInt operator+(BigInt &&lhs, const BigInt &rhs) { return std::move(lhs += rhs); }
-
-BigInt operator+(BigInt &&lhs, BigInt &&rhs)
-{
-    if (rhs.chunks.capacity() > lhs.chunks.capacity())
-        return std::move(rhs += lhs);
-    return std::move(lhs += rhs);
+// r = a * b through the three transforms, then Garner's CRT per chunk,
+// x = x0 + p0 * t1 + p0 * p1 * t2, with a running carry below 2^(2 * ChunkBits - 2)
+static void nttMul(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
+{
+    const auto rn = an + bn, len = std::bit_ceil(rn - 1);
+    const auto x0 = scratch, x1 = x0 + len, x2 = x1 + len, y = x2 + len;
+    nttConvolve<NttP0, NttG0>(x0, len, a, an, b, bn, y);
+    nttConvolve<NttP1, NttG1>(x1, len, a, an, b, bn, y);
+    nttConvolve<NttP2, NttG2>(x2, len, a, an, b, bn, y);
+    using F1 = NttField<NttP1>;
+    using F2 = NttField<NttP2>;
+    constexpr auto p01 = static_cast<DoubleChunk>(NttP0) * NttP1;
+    constexpr auto p01Lo = static_cast<Chunk>(p01), p01Hi = static_cast<Chunk>(p01 >> ChunkBits);
+    // the inverses are in Montgomery form, so one mul by them takes it out
+    constexpr auto inv0 = F1::pow(F1::toMont(NttP0 % NttP1), NttP1 - 2);
+    constexpr auto inv01 = F2::pow(F2::toMont(static_cast<Chunk>(p01 % NttP2)), NttP2 - 2);
+    DoubleChunk carry = 0;
+    for (std::size_t i = 0; i < rn; ++i)
+    {
+        DoubleChunk lo = 0;
+        Chunk t2 = 0;
+        if (i + 1 < rn)
+        {
+            const auto t1 = F1::mul(F1::sub(x1[i], x0[i] % NttP1), inv0);
+            lo = x0[i] + static_cast<DoubleChunk>(NttP0) * t1;
+            t2 = F2::mul(F2::sub(x2[i], static_cast<Chunk>(lo % NttP2)), inv01);
+        }
+        const auto mid = static_cast<DoubleChunk>(p01Lo) * t2;
+        const auto low = static_cast<DoubleChunk>(static_cast<Chunk>(carry)) + static_cast<Chunk>(lo) + static_cast<Chunk>(mid);
+        r[i] = static_cast<Chunk>(low);
+        carry = (low >> ChunkBits) + (carry >> ChunkBits) + (lo >> ChunkBits) + (mid >> ChunkBits) + static_cast<DoubleChunk>(p01Hi) * t2;
+    }
 }
 
-BigInt operator-(const BigInt &lhs, const BigInt &rhs)
+// r = a * b with r having an + bn chunks, an >= bn >= 1, and r not
+// overlapping a, b, or the mulScratch(an, bn) chunks of scratch
+static void mulRec(Chunk *r, const Chunk *a, const std::size_t an, const Chunk *b, const std::size_t bn, Chunk *scratch)
 {
-    if (rhs.chunks.size() > lhs.chunks.size())
+    switch (mulKind(an, bn))
     {
-        auto res = rhs;
-        res.negate();
-        res += lhs;
-        return res;
+    case MulKind::Basecase:
+        return mulBasecase(r, a, an, b, bn);
+    case MulKind::Blocks:
+        return mulBlocks(r, a, an, b, bn, scratch);
+    case MulKind::Toom2:
+        return toom2Mul(r, a, an, b, bn, scratch);
+    case MulKind::Toom3:
+        return toom3Mul(r, a, an, b, bn, scratch);
+    case MulKind::Toom4:
+        return toom4Mul(r, a, an, b, bn, scratch);
+    case MulKind::Toom8:
+        return toom8Mul(r, a, an, b, bn, scratch);
+    case MulKind::Toom32:
+        return toom32Mul(r, a, an, b, bn, scratch);
+    case MulKind::Toom42:
+        return toom42Mul(r, a, an, b, bn, scratch);
+    case MulKind::Ntt:
+        return nttMul(r, a, an, b, bn, scratch);
     }
-    if (&lhs == &rhs)
-        return Zero();
-    auto res = lhs;
-    res -= rhs;
-    return res;
 }
 
-BigInt operator-(const BigInt &lhs, BigInt &&rhs)
+// r = a * a with r having 2n chunks, n >= 1, using at most mulScratch(n, n)
+// chunks of scratch
+static void sqrRec(Chunk *r, const Chunk *a, const std::size_t n, Chunk *scratch)
 {
-    if (&lhs == &rhs)
-        return std::move(rhs = Zero());
-    rhs.negate();
-    return std::move(rhs += lhs);
+    switch (mulKind(n, n))
+    {
+    case MulKind::Basecase:
+    case MulKind::Blocks:
+    case MulKind::Toom32:
+    case MulKind::Toom42:
+        if (n < SqrBasecaseThresh)
+            return mulBasecase(r, a, n, a, n);
+        return sqrBasecase(r, a, n);
+    case MulKind::Toom2:
+        return toom2Sqr(r, a, n, scratch);
+    case MulKind::Toom3:
+        return toom3Sqr(r, a, n, scratch);
+    case MulKind::Toom4:
+        return toom4Sqr(r, a, n, scratch);
+    case MulKind::Toom8:
+        return toom8Sqr(r, a, n, scratch);
+    case MulKind::Ntt:
+        return nttMul(r, a, n, a, n, scratch);
+    }
 }
 
-BigInt operator-(BigInt &&lhs, const BigInt &rhs) { return std::move(lhs -= rhs); }
-
-BigInt operator-(BigInt &&lhs, BigInt &&rhs)
+std::size_t BigInt::mulScratchSize(const std::size_t lhsSize, const std::size_t rhsSize)
 {
-    if (rhs.chunks.capacity() > lhs.chunks.capacity())
-        return lhs - std::move(rhs);
-    return std::move(lhs -= rhs);
+    if (lhsSize == 0 || rhsSize == 0)
+        return 0;
+    return lhsSize + rhsSize + mulScratch(std::max(lhsSize, rhsSize), std::min(lhsSize, rhsSize));
 }
 
-static BigInt mul(const BigInt &lhs, const BigInt &rhs)
+// dst = lhs * rhs in dst's buffer, squaring when both view the same chunks.
+// The operands may view dst's own chunks: a schoolbook product of dst by
+// another operand runs in place from the top row down, otherwise aliased
+// operands are copied into the scratch buffer first.
+static void mulInto(BigInt &dst, BigIntView lhs, BigIntView rhs)
 {
-    BigInt res;
-    res.chunks.resize(lhs.chunks.size() + rhs.chunks.size() + 1);
-    for (std::size_t i = 0; i < lhs.chunks.size(); ++i)
+    if (lhs.chunks.size() < rhs.chunks.size())
+        std::swap(lhs, rhs);
+    const auto an = lhs.chunks.size(), bn = rhs.chunks.size();
+    const auto offset = lhs.offset + rhs.offset;
+    const bool isNeg = lhs.isNeg != rhs.isNeg;
+    if (bn == 0)
+    {
+        dst.chunks.clear();
+        dst.normalize();
+        return;
+    }
+    const auto aliasA = overlaps(dst, lhs), aliasB = overlaps(dst, rhs);
+    if (lhs.chunks.data() == rhs.chunks.data() && an == bn)
+    {
+        const auto sn = mulScratch(an, an);
+        ChunkVec scratch;
+        scratch.resizeForOverwrite(sn + (aliasA ? an : 0));
+        auto a = lhs.chunks.data();
+        if (aliasA)
+            a = std::copy(a, a + an, scratch.data() + sn) - an;
+        dst.chunks.resize(2 * an);
+        sqrRec(dst.chunks.data(), a, an, scratch.data());
+    }
+    else if (aliasA && !aliasB && viewsAll(dst, lhs) && mulKind(an, bn) == MulKind::Basecase)
     {
-        for (std::size_t j = 0; j < rhs.chunks.size(); ++j)
+        dst.chunks.resize(an + bn);
+        const auto r = dst.chunks.data();
+        for (auto i = an; i--;)
         {
-            auto prod = static_cast<std::uint64_t>(lhs.chunks[i]) * rhs.chunks[j];
-            if (prod)
-                addChunk(res.chunks, i + j, static_cast<std::uint32_t>(prod));
-            if (prod >> 32)
-                addChunk(res.chunks, i + j + 1, static_cast<std::uint32_t>(prod >> 32));
+            const auto m = r[i];
+            r[i] = 0;
+            const auto carry = addMul1(r + i, rhs.chunks.data(), bn, m);
+            addInto(r + i + bn, an - i, &carry, 1);
         }
     }
-    return res;
-}
-
-struct Toom2Split
-{
-    BigInt low, high;
-
-    Toom2Split(const BigInt &big, const std::size_t sz)
+    else
     {
-        auto iter1 = big.chunks.begin();
-        auto iter2 = iter1 + std::min<std::ptrdiff_t>(sz, big.chunks.end() - iter1);
-        auto iter3 = big.chunks.end();
-        low.chunks = std::vector<std::uint32_t>(iter1, iter2);
-        high.chunks = std::vector<std::uint32_t>(iter2, iter3);
-        low.normalize();
-        high.normalize();
+        const auto sn = mulScratch(an, bn);
+        ChunkVec scratch;
+        scratch.resizeForOverwrite(sn + (aliasA ? an : 0) + (aliasB ? bn : 0));
+        auto a = lhs.chunks.data(), b = rhs.chunks.data();
+        auto copy = scratch.data() + sn;
+        if (aliasA)
+        {
+            std::copy(a, a + an, copy);
+            a = copy;
+            copy += an;
+        }
+        if (aliasB)
+        {
+            std::copy(b, b + bn, copy);
+            b = copy;
+        }
+        dst.chunks.resize(an + bn);
+        mulRec(dst.chunks.data(), a, an, b, bn, scratch.data());
     }
-};
+    dst.offset = offset;
+    dst.isNeg = isNeg;
+    dst.normalize();
+}
 
-static BigInt toom2(const BigInt &lhs, const BigInt &rhs)
+static BigInt multiply(const BigIntView lhs, const BigIntView rhs)
 {
-    const auto sz = ceilDiv(std::max(lhs.chunks.size(), rhs.chunks.size()), 2);
-    Toom2Split p(lhs, sz);
-    Toom2Split q(rhs, sz);
-    std::array<BigInt, 3> r;
-    r[0] = p.low * q.low;
-    r[2] = p.high * q.high;
-    r[1] = r[0] + r[2];
-    r[1] -= (std::move(p.high) - std::move(p.low)) * (std::move(q.high) - std::move(q.low));
     BigInt res;
-    res.chunks.resize(lhs.chunks.size() + rhs.chunks.size() + 1);
-    for (std::size_t i = 0; i < r.size(); ++i)
-    {
-        for (std::size_t j = 0; j < r[i].chunks.size(); ++j)
-        {
-            if (r[i].chunks[j])
-                addChunk(res.chunks, sz * i + j, r[i].chunks[j]);
-        }
-    }
+    mulInto(res, lhs, rhs);
     return res;
 }
 
-struct Toom3Mat
-{
-    BigInt zero, one, negone, negtwo, inf;
+void BigInt::mul(BigInt &dst, const BigIntView lhs, const BigIntView rhs) { mulInto(dst, lhs, rhs); }
 
-    Toom3Mat(const BigInt &big, const std::size_t sz)
-    {
-        BigInt b0, b1, b2;
-        auto iter1 = big.chunks.begin();
-        auto iter2 = iter1 + std::min<std::ptrdiff_t>(sz, big.chunks.end() - iter1);
-        auto iter3 = iter2 + std::min<std::ptrdiff_t>(sz, big.chunks.end() - iter2);
-        auto iter4 = big.chunks.end();
-        b0.chunks = std::vector<std::uint32_t>(iter1, iter2);
-        b1.chunks = std::vector<std::uint32_t>(iter2, iter3);
-        b2.chunks = std::vector<std::uint32_t>(iter3, iter4);
-        b0.normalize();
-        b1.normalize();
-        b2.normalize();
-        auto tmp = b0 + b2;
-        zero = b0;
-        one = tmp + b1;
-        negone = std::move(tmp) - std::move(b1);
-        negtwo = ((negone + b2) << 1) - std::move(b0);
-        inf = std::move(b2);
-    }
-};
+BigInt BigInt::square(const BigInt &num) { return multiply(num, num); }
 
-static BigInt div2(BigInt &&big)
+BigInt operator*(const BigInt &lhs, const BigInt &rhs) { return multiply(lhs, rhs); }
+BigInt operator*(const BigInt &lhs, BigInt &&rhs) { return std::move(rhs *= lhs); }
+BigInt operator*(BigInt &&lhs, const BigInt &rhs) { return std::move(lhs *= rhs); }
+BigInt operator*(BigInt &&lhs, BigInt &&rhs) { return std::move(lhs *= std::move(rhs)); }
+
+// acc += a * b, or acc -= a * b when sub is set
+static void mulAccumulate(BigInt &acc, BigIntView a, BigIntView b, const bool sub)
 {
-    static const BigInt negOne(-1);
-    if (big == negOne)
-        return Zero();
+    if (a.chunks.size() < b.chunks.size())
+        std::swap(a, b);
+    if (b.chunks.empty())
+        return;
+    if (b.chunks.size() >= Toom2Thresh || overlaps(acc, a) || overlaps(acc, b))
+    {
+        const auto prod = multiply(a, b);
+        if (sub)
+            subSigned(acc, prod);
+        else
+            addSigned(acc, prod);
+        return;
+    }
+    const bool prodIsNeg = (a.isNeg != b.isNeg) != sub;
+    if (acc.chunks.empty())
+        acc.isNeg = prodIsNeg;
+    const auto an = a.chunks.size(), bn = b.chunks.size();
+    const auto pos = alignOffset(acc, BigIntView({}, false, a.offset + b.offset));
+    // one spare chunk on top of both, so the top chunk tells the sign of a
+    // difference taken modulo the whole buffer
+    acc.chunks.resize(std::max(acc.chunks.size(), pos + an + bn) + 1);
+    const auto n = acc.chunks.size();
+    const auto r = acc.chunks.data();
+    if (acc.isNeg == prodIsNeg)
+    {
+        for (std::size_t j = 0; j < bn; ++j)
+        {
+            const auto carry = addMul1(r + pos + j, a.chunks.data(), an, b.chunks[j]);
+            addInto(r + pos + j + an, n - pos - j - an, &carry, 1);
+        }
+    }
     else
-        return std::move(big >>= 1);
-}
-
-static BigInt toom3(const BigInt &lhs, const BigInt &rhs)
-{
-    static const BigInt three(3);
-    const auto sz = ceilDiv(std::max(lhs.chunks.size(), rhs.chunks.size()), 3);
-    Toom3Mat p(lhs, sz);
-    Toom3Mat q(rhs, sz);
-    p.zero *= q.zero;
-    p.one *= q.one;
-    p.negone *= q.negone;
-    p.negtwo *= q.negtwo;
-    p.inf *= q.inf;
-    std::array<BigInt, 5> r;
-    r[0] = p.zero;
-    r[4] = p.inf;
-    r[3] = (std::move(p.negtwo) - p.one) / three;
-    r[1] = div2(std::move(p.one) - p.negone);
-    r[2] = std::move(p.negone) - std::move(p.zero);
-    r[3] = div2(r[2] - r[3]) + (std::move(p.inf) << 1);
-    r[2] += r[1] - r[4];
-    r[1] -= r[3];
-    BigInt res;
-    res.chunks.resize(lhs.chunks.size() + rhs.chunks.size() + 1);
-    for (std::size_t i = 0; i < r.size(); ++i)
     {
-        for (std::size_t j = 0; j < r[i].chunks.size(); ++j)
+        for (std::size_t j = 0; j < bn; ++j)
+        {
+            auto borrow = subMul1(r + pos + j, a.chunks.data(), an, b.chunks[j]);
+            for (auto i = pos + j + an; borrow && i < n; ++i)
+            {
+                const auto x = r[i];
+                r[i] = x - borrow;
+                borrow = x < borrow;
+            }
+        }
+        if (r[n - 1])
         {
-            if (r[i].chunks[j])
-                addChunk(res.chunks, sz * i + j, r[i].chunks[j]);
+            negateN(r, n);
+            acc.isNeg = !acc.isNeg;
         }
     }
-    return res;
+    acc.normalize();
 }
 
-static constexpr std::size_t Toom2Thresh = 550;
-static constexpr std::size_t Toom3Thresh = 2200;
+BigInt &BigInt::addMul(const BigIntView a, const BigIntView b)
+{
+    mulAccumulate(*this, a, b, false);
+    return *this;
+}
 
-BigInt operator*(const BigInt &lhs, const BigInt &rhs)
+BigInt &BigInt::subMul(const BigIntView a, const BigIntView b)
 {
-    const auto score = lhs.chunks.size() * rhs.chunks.size();
-    auto res = score > Toom3Thresh   ? toom3(lhs, rhs)
-               : score > Toom2Thresh ? toom2(lhs, rhs)
-                                     : mul(lhs, rhs);
-    res.isNeg = lhs.isNeg != rhs.isNeg;
-    res.normalize();
-    return res;
+    mulAccumulate(*this, a, b, true);
+    return *this;
 }
 
 BigInt operator/(const BigInt &lhs, const BigInt &rhs) { return BigInt::divmod(lhs, rhs).q; }
@@ -890,6 +3253,90 @@ BigInt operator%(const BigInt &lhs, BigInt &&rhs) { return BigInt::divmod(lhs, s
 BigInt operator%(BigInt &&lhs, const BigInt &rhs) { return BigInt::divmod(std::move(lhs), rhs).r; }
 BigInt operator%(BigInt &&lhs, BigInt &&rhs) { return BigInt::divmod(std::move(lhs), std::move(rhs)).r; }
 
+static BigInt nativeBigInt(const BigIntNative num)
+{
+    BigInt res(static_cast<unsigned long long>(num.mag));
+    if (num.isNeg)
+        res.negate();
+    return res;
+}
+
+static constexpr auto MaxChunk = static_cast<Chunk>(-1);
+
+BigInt &BigInt::addNative(const BigIntNative num)
+{
+    std::array<Chunk, NativeChunks> buf;
+    addSigned(*this, nativeView(buf, num));
+    return *this;
+}
+
+BigInt &BigInt::subNative(const BigIntNative num)
+{
+    std::array<Chunk, NativeChunks> buf;
+    subSigned(*this, nativeView(buf, num));
+    return *this;
+}
+
+BigInt &BigInt::mulNative(const BigIntNative num)
+{
+    if (num.mag > MaxChunk)
+    {
+        std::array<Chunk, NativeChunks> buf;
+        return *this = multiply(*this, nativeView(buf, num));
+    }
+    if (num.mag == 0)
+        chunks.clear();
+    else if (const auto carry = mul1(chunks.data(), chunks.data(), chunks.size(), static_cast<Chunk>(num.mag)))
+        chunks.push_back(carry);
+    isNeg = isNeg != num.isNeg;
+    normalize();
+    return *this;
+}
+
+BigInt &BigInt::divNative(const BigIntNative num)
+{
+    if (num.mag > MaxChunk)
+        return *this = std::move(*this) / nativeBigInt(num);
+    if (num.mag == 0)
+        throw std::invalid_argument("BigInt divmod rhs is zero");
+    flatten();
+    divRem1(chunks.data(), chunks.data(), chunks.size(), static_cast<Chunk>(num.mag));
+    isNeg = isNeg != num.isNeg;
+    normalize();
+    return *this;
+}
+
+BigInt BigInt::remNative(const BigIntNative num) const
+{
+    if (num.mag > MaxChunk)
+        return *this % nativeBigInt(num);
+    if (num.mag == 0)
+        throw std::invalid_argument("BigInt divmod rhs is zero");
+    BigInt res(divRem1(nullptr, chunks.data(), chunks.size(), static_cast<Chunk>(num.mag), offset));
+    res.isNeg = isNeg && res.chunks.size();
+    return res;
+}
+
+BigInt &BigInt::addMulNative(const BigIntView a, const BigIntNative m)
+{
+    std::array<Chunk, NativeChunks> buf;
+    mulAccumulate(*this, a, nativeView(buf, m), false);
+    return *this;
+}
+
+BigInt &BigInt::subMulNative(const BigIntView a, const BigIntNative m)
+{
+    std::array<Chunk, NativeChunks> buf;
+    mulAccumulate(*this, a, nativeView(buf, m), true);
+    return *this;
+}
+
+std::strong_ordering BigInt::cmpNative(const BigIntNative num) const
+{
+    std::array<Chunk, NativeChunks> buf;
+    return BigIntView(*this) <=> nativeView(buf, num);
+}
+
 BigInt operator&(const BigInt &lhs, const BigInt &rhs)
 {
     if (rhs.chunks.size() > lhs.chunks.size())
@@ -979,38 +3426,57 @@ BigInt operator>>(BigInt &&lhs, std::int64_t rhs) { return std::move(lhs >>= rhs
 
 bool operator==(const BigInt &lhs, const BigInt &rhs)
 {
-    return &lhs == &rhs ||
-           (lhs.isNeg == rhs.isNeg && lhs.chunks == rhs.chunks);
+    return &lhs == &rhs || BigIntView(lhs) == BigIntView(rhs);
+}
+
+bool operator==(const BigIntView lhs, const BigIntView rhs)
+{
+    if (lhs.offset == rhs.offset)
+        return lhs.isNeg == rhs.isNeg &&
+               std::equal(lhs.chunks.begin(), lhs.chunks.end(), rhs.chunks.begin(), rhs.chunks.end());
+    return lhs.isNeg == rhs.isNeg && cmpMag(lhs, rhs) == 0;
 }
 
-static std::strong_ordering cmp(const BigInt &diff)
+std::strong_ordering operator<=>(const BigInt &lhs, const BigInt &rhs) { return BigIntView(lhs) <=> BigIntView(rhs); }
+std::strong_ordering operator<=>(const BigInt &lhs, BigInt &&rhs) { return BigIntView(lhs) <=> BigIntView(rhs); }
+std::strong_ordering operator<=>(BigInt &&lhs, const BigInt &rhs) { return BigIntView(lhs) <=> BigIntView(rhs); }
+std::strong_ordering operator<=>(BigInt &&lhs, BigInt &&rhs) { return BigIntView(lhs) <=> BigIntView(rhs); }
+
+std::strong_ordering operator<=>(const BigIntView lhs, const BigIntView rhs)
 {
-    return diff.chunks.size() == 0 ? std::strong_ordering::equal
-           : diff.isNeg            ? std::strong_ordering::less
-                                   : std::strong_ordering::greater;
+    if (lhs.isNeg != rhs.isNeg)
+        return lhs.isNeg ? std::strong_ordering::less : std::strong_ordering::greater;
+    const auto res = cmpMag(lhs, rhs);
+    return lhs.isNeg ? 0 <=> res : res;
 }
 
-std::strong_ordering operator<=>(const BigInt &lhs, const BigInt &rhs) { return cmp(lhs - rhs); }
-std::strong_ordering operator<=>(const BigInt &lhs, BigInt &&rhs) { return cmp(lhs - std::move(rhs)); }
-std::strong_ordering operator<=>(BigInt &&lhs, const BigInt &rhs) { return cmp(std::move(lhs) - rhs); }
-std::strong_ordering operator<=>(BigInt &&lhs, BigInt &&rhs) { return cmp(std::move(lhs) - std::move(rhs)); }
+std::size_t std::hash<BigInt>::operator()(const BigInt &val) const noexcept { return std::hash<BigIntView>{}(val); }
 
-std::size_t std::hash<BigInt>::operator()(const BigInt &val) const noexcept
+std::size_t std::hash<BigIntView>::operator()(const BigIntView val) const noexcept
 {
+    // hashes 32 bit words so the result doesn't depend on the chunk size
+    constexpr std::size_t wordsPerChunk = sizeof(Chunk) / sizeof(std::uint32_t);
+    auto word = [&](std::size_t i)
+    { return static_cast<std::uint32_t>(chunkAt(val, i / wordsPerChunk) >> i % wordsPerChunk * 32); };
+    auto words = (val.offset + val.chunks.size()) * wordsPerChunk;
+    while (words && word(words - 1) == 0)
+    {
+        --words;
+    }
     constexpr std::size_t lim = 32;
-    const auto mid = val.chunks.size() / 2;
+    const auto mid = words / 2;
     std::hash<std::uint32_t> u32Hash;
     std::size_t h1 = 0;
     for (auto i = mid <= lim ? mid : lim; i--;)
     {
         h1 <<= 2;
-        h1 ^= u32Hash(val.chunks[i]);
+        h1 ^= u32Hash(word(i));
     }
     std::size_t h2 = 0;
-    for (auto i = mid <= lim ? mid : val.chunks.size() - lim; i < val.chunks.size(); ++i)
+    for (auto i = mid <= lim ? mid : words - lim; i < words; ++i)
     {
         h2 <<= 2;
-        h2 ^= u32Hash(val.chunks[i]);
+        h2 ^= u32Hash(word(i));
     }
     return std::hash<bool>{}(val.isNeg) ^ h1 << 1 ^ h2 << 2;
 }
@@ -1,15 +1,235 @@
 #pragma once
+#include <array>
+#include <bit>
 #include <compare>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
+struct BigInt;
 struct DivModRes;
 
+// Chunks are 32 bits by default. Building with BIGINT_CHUNK64 defined switches
+// to 64 bit chunks with unsigned __int128 products, which needs GCC or Clang.
+#ifdef BIGINT_CHUNK64
+using BigIntChunk = std::uint64_t;
+__extension__ using BigIntDoubleChunk = unsigned __int128;
+#else
+using BigIntChunk = std::uint32_t;
+using BigIntDoubleChunk = std::uint64_t;
+#endif
+
+// Vector like container of chunks that stores up to InlineCapacity chunks
+// inside the object itself and only allocates once it grows past that. Heap
+// storage comes from a std::pmr::memory_resource, by default the one of the
+// innermost BigIntResourceScope on this thread or else
+// std::pmr::get_default_resource(). Like a std::pmr::vector the resource is
+// kept for the lifetime of the container, a move assignment from a container
+// using another resource copies the chunks.
+//
+// After share() heap storage is reference counted and copies of the container
+// share it, so copying a large read-mostly value is O(1). The first write
+// through a copy (any non-const access) gives it its own buffer, which stays
+// shared with later copies. Shared buffers keep the resource they were
+// allocated from. The reference count is atomic, so copies may live on
+// different threads.
+class ChunkVec
+{
+public:
+    static constexpr std::size_t InlineCapacity = 16 / sizeof(BigIntChunk);
+
+    ChunkVec() noexcept;
+    explicit ChunkVec(std::pmr::memory_resource *res) noexcept;
+    ChunkVec(const BigIntChunk *first, const BigIntChunk *last);
+    ChunkVec(const ChunkVec &other);
+    ChunkVec(ChunkVec &&other) noexcept;
+    ChunkVec &operator=(const ChunkVec &other);
+    ChunkVec &operator=(ChunkVec &&other) noexcept;
+    ~ChunkVec();
+
+    std::size_t size() const { return sz; }
+    std::size_t capacity() const { return cap; }
+    bool empty() const { return sz == 0; }
+    BigIntChunk *data() { return detach(), ptr; }
+    const BigIntChunk *data() const { return ptr; }
+    BigIntChunk *begin() { return detach(), ptr; }
+    const BigIntChunk *begin() const { return ptr; }
+    BigIntChunk *end() { return detach(), ptr + sz; }
+    const BigIntChunk *end() const { return ptr + sz; }
+    BigIntChunk &operator[](std::size_t i) { return detach(), ptr[i]; }
+    const BigIntChunk &operator[](std::size_t i) const { return ptr[i]; }
+    BigIntChunk &back() { return detach(), ptr[sz - 1]; }
+    const BigIntChunk &back() const { return ptr[sz - 1]; }
+    std::pmr::memory_resource *resource() const { return res; }
+    bool isShared() const { return shared; }
+    std::size_t useCount() const;
+
+    void assign(const BigIntChunk *first, const BigIntChunk *last);
+    void reserve(std::size_t n);
+    void resize(std::size_t n);
+    // like resize, but leaves new chunks uninitialized for the caller to overwrite
+    void resizeForOverwrite(std::size_t n);
+    void clear() { sz = 0; }
+    void push_back(BigIntChunk val);
+    void pop_back() { --sz; }
+    void shrink_to_fit();
+    void share();
+
+    static std::pmr::memory_resource *defaultResource();
+
+private:
+    BigIntChunk *ptr;
+    std::size_t sz;
+    std::size_t cap;
+    std::pmr::memory_resource *res;
+    bool shared;
+    BigIntChunk buf[InlineCapacity];
+
+    bool isInline() const { return ptr == buf; }
+    bool isUnique() const;
+    void detach()
+    {
+        if (shared)
+            unshare();
+    }
+    void unshare();
+    void adopt(const ChunkVec &other);
+    BigIntChunk *allocate(std::size_t &n);
+    void freeStorage();
+    void reallocate(std::size_t n);
+};
+
+bool operator==(const ChunkVec &lhs, const ChunkVec &rhs);
+
+// While alive every BigInt created on this thread allocates from res, so a
+// whole computation can run on an arena like std::pmr::monotonic_buffer_resource.
+// Results that should outlive the arena have to be assigned (not move
+// constructed) to a BigInt created outside of the scope.
+class BigIntResourceScope
+{
+public:
+    explicit BigIntResourceScope(std::pmr::memory_resource *res);
+    BigIntResourceScope(const BigIntResourceScope &) = delete;
+    BigIntResourceScope &operator=(const BigIntResourceScope &) = delete;
+    ~BigIntResourceScope();
+
+private:
+    std::pmr::memory_resource *prev;
+};
+
+// Non-owning read-only view of a BigInt or of a range of its chunks, taken by
+// every operation that only reads an operand. The viewed chunks must outlive
+// the view and must not be modified through the owner while the view is in
+// use. Like BigInt::offset, offset counts zero chunks below chunks[0].
+struct BigIntView
+{
+    std::span<const BigIntChunk> chunks;
+    std::size_t offset = 0;
+    bool isNeg = false;
+
+    BigIntView() = default;
+    BigIntView(const BigInt &big);
+    constexpr BigIntView(std::span<const BigIntChunk> chunks, bool isNeg = false, std::size_t offset = 0)
+        : chunks(chunks), offset(offset), isNeg(isNeg) {}
+
+    BigIntView slice(std::size_t pos, std::size_t count) const;
+    void normalize();
+
+    // the bit queries of BigInt
+    std::int64_t bitLength() const;
+    std::int64_t popcount() const;
+    std::int64_t countTrailingZeros() const;
+    bool testBit(std::int64_t i) const;
+};
+
+// Opt-in per thread cache of freed chunk buffers. While enabled on a thread,
+// heap buffers that come from std::pmr::new_delete_resource() are rounded up
+// to power of two sizes, and buffers freed on that thread are kept in per size
+// free lists (up to maxCachedBytes) and handed out again to new BigInts
+// instead of going back to operator delete. Buffers may be freed on any
+// thread, they go to that thread's pool or back to operator delete.
+struct BigIntPool
+{
+    static constexpr std::size_t DefaultMaxCachedBytes = 32 << 20;
+
+    struct Stats
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t cached = 0;
+        std::uint64_t freed = 0;
+
+        double hitRate() const;
+    };
+
+    static void enable(std::size_t maxCachedBytes = DefaultMaxCachedBytes);
+    static void disable();
+    static bool enabled();
+    static void release();
+    static Stats stats();
+    static void resetStats();
+};
+
+template <typename T>
+concept BigIntNativeInt = std::integral<T> && !std::same_as<T, bool> && sizeof(T) <= sizeof(std::uint64_t);
+
+// Native integer operand split in magnitude and sign, taken by the single
+// chunk kernels behind BigInt's native integer overloads.
+struct BigIntNative
+{
+    std::uint64_t mag;
+    bool isNeg;
+
+    template <BigIntNativeInt T>
+    constexpr BigIntNative(const T num) : mag(static_cast<std::uint64_t>(num)), isNeg(false)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (num < 0)
+            {
+                mag = 0 - mag;
+                isNeg = true;
+            }
+        }
+    }
+};
+
+// Picks the implementation of the inner add, subtract and multiply accumulate
+// kernels. Only 64 bit chunk builds for x86-64 have an accelerated path, the
+// BMI2 mulx plus adcx kernels, used by default on a CPU that has them. The
+// default 32 bit chunk build always runs the portable ones. Forcing one lets
+// both be checked against each other on the same machine.
+struct BigIntKernels
+{
+    enum class Kind
+    {
+        Portable,
+        Adx,
+    };
+
+    static bool available(Kind kind);
+    static Kind active();
+    static void force(Kind kind);
+    static void reset();
+};
+
 struct BigInt
 {
-    std::vector<std::uint32_t> chunks;
+    using Chunk = BigIntChunk;
+    static constexpr int ChunkBits = sizeof(Chunk) * 8;
+
+    // The magnitude is chunks shifted left by offset chunks, so shifts by
+    // whole chunks don't have to move or store the low zero chunks. Code that
+    // reads chunks directly should call flatten() first.
+    ChunkVec chunks;
+    std::size_t offset = 0;
     bool isNeg = false;
 
     BigInt();
@@ -22,12 +242,14 @@ struct BigInt
     explicit BigInt(float num);
     explicit BigInt(double num);
     explicit BigInt(long double num);
+    explicit BigInt(BigIntView view);
 
     BigInt &operator+=(const BigInt &other);
     BigInt &operator+=(BigInt &&other);
     BigInt &operator-=(const BigInt &other);
     BigInt &operator-=(BigInt &&rhs);
     BigInt &operator*=(const BigInt &other);
+    BigInt &operator*=(BigInt &&other);
     BigInt &operator/=(const BigInt &other);
     BigInt &operator/=(BigInt &&other);
     BigInt &operator%=(const BigInt &other);
@@ -40,6 +262,16 @@ struct BigInt
     BigInt &operator^=(BigInt &&other);
     BigInt &operator<<=(std::int64_t n);
     BigInt &operator>>=(std::int64_t n);
+    template <BigIntNativeInt T>
+    BigInt &operator+=(T num) { return addNative(num); }
+    template <BigIntNativeInt T>
+    BigInt &operator-=(T num) { return subNative(num); }
+    template <BigIntNativeInt T>
+    BigInt &operator*=(T num) { return mulNative(num); }
+    template <BigIntNativeInt T>
+    BigInt &operator/=(T num) { return divNative(num); }
+    template <BigIntNativeInt T>
+    BigInt &operator%=(T num) { return *this = remNative(num); }
     BigInt &operator++();
     BigInt &operator--();
     BigInt operator++(int);
@@ -50,10 +282,41 @@ struct BigInt
     BigInt operator~() &&;
     explicit operator bool() const;
 
+    BigInt &addNative(BigIntNative num);
+    BigInt &subNative(BigIntNative num);
+    BigInt &mulNative(BigIntNative num);
+    BigInt &divNative(BigIntNative num);
+    BigInt remNative(BigIntNative num) const;
+    std::strong_ordering cmpNative(BigIntNative num) const;
+
+    // *this += a * b and *this -= a * b. Below the Toom thresholds the rows of
+    // the product are accumulated straight into *this without a temporary.
+    BigInt &addMul(BigIntView a, BigIntView b);
+    BigInt &subMul(BigIntView a, BigIntView b);
+    template <BigIntNativeInt T>
+    BigInt &addMul(BigIntView a, T m) { return addMulNative(a, m); }
+    template <BigIntNativeInt T>
+    BigInt &subMul(BigIntView a, T m) { return subMulNative(a, m); }
+    BigInt &addMulNative(BigIntView a, BigIntNative m);
+    BigInt &subMulNative(BigIntView a, BigIntNative m);
+
     void normalize();
+    void flatten();
     void negate();
     void invert();
 
+    // Bit queries. bitLength and popcount are of the magnitude like Python's
+    // int.bit_length and int.bit_count, countTrailingZeros is 0 for zero. The
+    // bit index methods see negatives as two's complement like the bitwise
+    // operators do.
+    std::int64_t bitLength() const;
+    std::int64_t popcount() const;
+    std::int64_t countTrailingZeros() const;
+    bool testBit(std::int64_t i) const;
+    BigInt &setBit(std::int64_t i);
+    BigInt &clearBit(std::int64_t i);
+    BigInt &flipBit(std::int64_t i);
+
     std::int64_t toInteger() const;
     float toFloat() const;
     double toDouble() const;
@@ -69,6 +332,24 @@ struct BigInt
     static DivModRes divmod(BigInt &&lhs, const BigInt &rhs);
     static DivModRes divmod(BigInt &&lhs, BigInt &&rhs);
     static BigInt pow(const BigInt &base, std::int64_t exp);
+    // num * num with about half the chunk products, also picked by the
+    // multiplication operators when both operands are the same object
+    static BigInt square(const BigInt &num);
+    // Destination forms of the operators. dst is overwritten with the result
+    // and keeps its chunk capacity, so loops that reuse their temporaries stop
+    // allocating once the buffers are big enough. The operands may be dst or
+    // views of its chunks, a multiplication by dst then runs in place.
+    static void add(BigInt &dst, BigIntView lhs, BigIntView rhs);
+    static void sub(BigInt &dst, BigIntView lhs, BigIntView rhs);
+    static void mul(BigInt &dst, BigIntView lhs, BigIntView rhs);
+    static void divmod(BigInt &q, BigInt &r, BigIntView lhs, BigIntView rhs);
+    static void shiftLeft(BigInt &dst, const BigInt &lhs, std::int64_t n);
+    static void shiftRight(BigInt &dst, const BigInt &lhs, std::int64_t n);
+    // peak number of chunks a product of operands with that many chunks
+    // allocates: the lhsSize + rhsSize chunks of the result plus the scratch
+    // buffer every multiplication tier runs in, NTT transforms included. The
+    // NTT root tables are cached per thread and not counted.
+    static std::size_t mulScratchSize(std::size_t lhsSize, std::size_t rhsSize);
 };
 
 struct DivModRes
@@ -77,6 +358,26 @@ struct DivModRes
     BigInt r;
 };
 
+// Sums a long stream of values with delayed carry propagation. Each chunk of
+// an added value goes into a double width counter at its position, positive
+// and negative values into separate counters, so an addition is one pass over
+// the value's chunks with no carries or normalization. Carries are propagated
+// only before the counters could overflow and when total() is read.
+// Accumulators filled on different threads can be merged.
+struct BigIntAccumulator
+{
+    std::vector<BigIntDoubleChunk> pos;
+    std::vector<BigIntDoubleChunk> neg;
+    // values added since the counters were last carried
+    std::uint64_t pending = 0;
+
+    BigIntAccumulator &operator+=(BigIntView val);
+    BigIntAccumulator &operator-=(BigIntView val);
+    BigIntAccumulator &merge(const BigIntAccumulator &other);
+    BigInt total() const;
+    void clear();
+};
+
 BigInt operator+(const BigInt &lhs, const BigInt &rhs);
 BigInt operator+(const BigInt &lhs, BigInt &&rhs);
 BigInt operator+(BigInt &&lhs, const BigInt &rhs);
@@ -86,6 +387,9 @@ BigInt operator-(const BigInt &lhs, BigInt &&rhs);
 BigInt operator-(BigInt &&lhs, const BigInt &rhs);
 BigInt operator-(BigInt &&lhs, BigInt &&rhs);
 BigInt operator*(const BigInt &lhs, const BigInt &rhs);
+BigInt operator*(const BigInt &lhs, BigInt &&rhs);
+BigInt operator*(BigInt &&lhs, const BigInt &rhs);
+BigInt operator*(BigInt &&lhs, BigInt &&rhs);
 BigInt operator/(const BigInt &lhs, const BigInt &rhs);
 BigInt operator/(const BigInt &lhs, BigInt &&rhs);
 BigInt operator/(BigInt &&lhs, const BigInt &rhs);
@@ -111,13 +415,525 @@ BigInt operator<<(BigInt &&lhs, std::int64_t rhs);
 BigInt operator>>(const BigInt &lhs, std::int64_t rhs);
 BigInt operator>>(BigInt &&lhs, std::int64_t rhs);
 bool operator==(const BigInt &lhs, const BigInt &rhs);
+bool operator==(BigIntView lhs, BigIntView rhs);
 std::strong_ordering operator<=>(const BigInt &lhs, const BigInt &rhs);
 std::strong_ordering operator<=>(const BigInt &lhs, BigInt &&rhs);
 std::strong_ordering operator<=>(BigInt &&lhs, const BigInt &rhs);
 std::strong_ordering operator<=>(BigInt &&lhs, BigInt &&rhs);
+std::strong_ordering operator<=>(BigIntView lhs, BigIntView rhs);
+
+// Native integer operands use the single chunk kernels instead of converting
+// to a BigInt first.
+template <BigIntNativeInt T>
+BigInt operator+(BigInt lhs, T rhs) { return std::move(lhs += rhs); }
+template <BigIntNativeInt T>
+BigInt operator+(T lhs, BigInt rhs) { return std::move(rhs += lhs); }
+template <BigIntNativeInt T>
+BigInt operator-(BigInt lhs, T rhs) { return std::move(lhs -= rhs); }
+
+template <BigIntNativeInt T>
+BigInt operator-(T lhs, BigInt rhs)
+{
+    rhs -= lhs;
+    rhs.negate();
+    return rhs;
+}
+
+template <BigIntNativeInt T>
+BigInt operator*(BigInt lhs, T rhs) { return std::move(lhs *= rhs); }
+template <BigIntNativeInt T>
+BigInt operator*(T lhs, BigInt rhs) { return std::move(rhs *= lhs); }
+template <BigIntNativeInt T>
+BigInt operator/(BigInt lhs, T rhs) { return std::move(lhs /= rhs); }
+template <BigIntNativeInt T>
+BigInt operator%(const BigInt &lhs, T rhs) { return lhs.remNative(rhs); }
+template <BigIntNativeInt T>
+BigInt operator%(BigInt &&lhs, T rhs) { return lhs.remNative(rhs); }
+template <BigIntNativeInt T>
+bool operator==(const BigInt &lhs, T rhs) { return lhs.cmpNative(rhs) == 0; }
+template <BigIntNativeInt T>
+bool operator==(BigInt &&lhs, T rhs) { return lhs.cmpNative(rhs) == 0; }
+template <BigIntNativeInt T>
+std::strong_ordering operator<=>(const BigInt &lhs, T rhs) { return lhs.cmpNative(rhs); }
+template <BigIntNativeInt T>
+std::strong_ordering operator<=>(BigInt &&lhs, T rhs) { return lhs.cmpNative(rhs); }
 
 template <>
 struct std::hash<BigInt>
 {
     std::size_t operator()(const BigInt &val) const noexcept;
 };
+
+template <>
+struct std::hash<BigIntView>
+{
+    std::size_t operator()(BigIntView val) const noexcept;
+};
+
+// Fixed width integer of Bits bits (a multiple of 64) stored inline, for hot
+// paths whose width is known at compile time. Uses the same schoolbook
+// multiplication and Knuth division as BigInt but on a std::array, so the loops
+// have constant bounds and nothing allocates. Arithmetic wraps around modulo
+// 2^Bits like the unsigned builtin types, BigSInt is two's complement with
+// BigInt's rounding for / and >>. Converting from a BigInt keeps the low Bits
+// bits of its two's complement.
+template <std::size_t Bits, bool Signed>
+struct BigFixedInt
+{
+    static_assert(Bits > 0 && Bits % 64 == 0, "BigFixedInt width has to be a multiple of 64 bits");
+
+    using Chunk = BigIntChunk;
+    static constexpr int ChunkBits = BigInt::ChunkBits;
+    static constexpr std::size_t Size = Bits / ChunkBits;
+
+    struct DivModRes;
+
+    std::array<Chunk, Size> chunks{};
+
+    constexpr BigFixedInt() = default;
+
+    template <std::integral T>
+    constexpr BigFixedInt(const T num)
+    {
+        const auto val = static_cast<std::uint64_t>(num);
+        Chunk fill = 0;
+        if constexpr (std::is_signed_v<T>)
+            fill = num < 0 ? static_cast<Chunk>(-1) : 0;
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            chunks[i] = i < 64 / ChunkBits ? static_cast<Chunk>(val >> i * ChunkBits) : fill;
+        }
+    }
+
+    explicit BigFixedInt(const BigInt &big)
+    {
+        for (std::size_t i = big.offset; i < Size && i - big.offset < big.chunks.size(); ++i)
+        {
+            chunks[i] = big.chunks[i - big.offset];
+        }
+        if (big.isNeg)
+            negate();
+    }
+
+    explicit operator BigInt() const
+    {
+        const auto neg = isNeg();
+        auto mag = *this;
+        if (neg)
+            mag.negate();
+        BigInt res;
+        res.chunks.assign(mag.chunks.data(), mag.chunks.data() + Size);
+        res.isNeg = neg;
+        res.normalize();
+        return res;
+    }
+
+    constexpr bool isNeg() const
+    {
+        if constexpr (Signed)
+            return chunks.back() >> (ChunkBits - 1);
+        else
+            return false;
+    }
+
+    constexpr explicit operator bool() const
+    {
+        for (const auto chunk : chunks)
+        {
+            if (chunk)
+                return true;
+        }
+        return false;
+    }
+
+    constexpr BigFixedInt &operator+=(const BigFixedInt &other)
+    {
+        Chunk carry = 0;
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            const Chunk x = chunks[i] + carry;
+            carry = x < carry;
+            chunks[i] = x + other.chunks[i];
+            carry += chunks[i] < x;
+        }
+        return *this;
+    }
+
+    constexpr BigFixedInt &operator-=(const BigFixedInt &other)
+    {
+        Chunk borrow = 0;
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            const Chunk x = chunks[i] - other.chunks[i];
+            const Chunk b = chunks[i] < other.chunks[i];
+            chunks[i] = x - borrow;
+            borrow = b | (x < borrow);
+        }
+        return *this;
+    }
+
+    constexpr BigFixedInt &operator*=(const BigFixedInt &other)
+    {
+        BigFixedInt res;
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            Chunk carry = 0;
+            for (std::size_t j = 0; i + j < Size; ++j)
+            {
+                const auto x = static_cast<BigIntDoubleChunk>(chunks[i]) * other.chunks[j] + res.chunks[i + j] + carry;
+                res.chunks[i + j] = static_cast<Chunk>(x);
+                carry = static_cast<Chunk>(x >> ChunkBits);
+            }
+        }
+        return *this = res;
+    }
+
+    constexpr BigFixedInt &operator/=(const BigFixedInt &other) { return *this = divmod(*this, other).q; }
+    constexpr BigFixedInt &operator%=(const BigFixedInt &other) { return *this = divmod(*this, other).r; }
+
+    constexpr BigFixedInt &operator&=(const BigFixedInt &other)
+    {
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            chunks[i] &= other.chunks[i];
+        }
+        return *this;
+    }
+
+    constexpr BigFixedInt &operator|=(const BigFixedInt &other)
+    {
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            chunks[i] |= other.chunks[i];
+        }
+        return *this;
+    }
+
+    constexpr BigFixedInt &operator^=(const BigFixedInt &other)
+    {
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            chunks[i] ^= other.chunks[i];
+        }
+        return *this;
+    }
+
+    constexpr BigFixedInt &operator<<=(const std::int64_t n)
+    {
+        if (n < 0)
+            throw std::invalid_argument("BigFixedInt operator<<= has negative shift");
+        const auto off = static_cast<std::size_t>(n / ChunkBits) < Size ? static_cast<std::size_t>(n / ChunkBits) : Size;
+        const auto s = n % ChunkBits;
+        for (std::size_t i = Size; i--;)
+        {
+            Chunk x = 0;
+            if (i >= off)
+                x = chunks[i - off] << s;
+            if (s && i >= off + 1)
+                x |= chunks[i - (off + 1)] >> (ChunkBits - s);
+            chunks[i] = x;
+        }
+        return *this;
+    }
+
+    constexpr BigFixedInt &operator>>=(const std::int64_t n)
+    {
+        if (n < 0)
+            throw std::invalid_argument("BigFixedInt operator>>= has negative shift");
+        const auto off = static_cast<std::size_t>(n / ChunkBits) < Size ? static_cast<std::size_t>(n / ChunkBits) : Size;
+        const auto s = n % ChunkBits;
+        const Chunk fill = isNeg() ? static_cast<Chunk>(-1) : 0;
+        auto at = [&](std::size_t i)
+        { return i < Size ? chunks[i] : fill; };
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            Chunk x = at(i + off) >> s;
+            if (s)
+                x |= at(i + off + 1) << (ChunkBits - s);
+            chunks[i] = x;
+        }
+        return *this;
+    }
+
+    constexpr BigFixedInt &operator++() { return *this += 1; }
+    constexpr BigFixedInt &operator--() { return *this -= 1; }
+
+    constexpr BigFixedInt operator++(int)
+    {
+        auto res = *this;
+        ++*this;
+        return res;
+    }
+
+    constexpr BigFixedInt operator--(int)
+    {
+        auto res = *this;
+        --*this;
+        return res;
+    }
+
+    constexpr BigFixedInt operator-() const
+    {
+        auto res = *this;
+        res.negate();
+        return res;
+    }
+
+    constexpr BigFixedInt operator~() const
+    {
+        auto res = *this;
+        res.invert();
+        return res;
+    }
+
+    constexpr void negate()
+    {
+        invert();
+        ++*this;
+    }
+
+    constexpr void invert()
+    {
+        for (auto &chunk : chunks)
+        {
+            chunk = ~chunk;
+        }
+    }
+
+    static constexpr BigFixedInt fromString(std::string_view str)
+    {
+        constexpr auto exceptionMsg = "BigFixedInt fromString has invalid argument";
+        const bool strIsNeg = str.size() && str[0] == '-';
+        if (strIsNeg)
+            str.remove_prefix(1);
+        if (str.size() == 0)
+            throw std::invalid_argument(exceptionMsg);
+        BigFixedInt res;
+        for (const auto c : str)
+        {
+            if (c < '0' || c > '9')
+                throw std::invalid_argument(exceptionMsg);
+            res *= 10;
+            res += c - '0';
+        }
+        if (strIsNeg)
+            res.negate();
+        return res;
+    }
+
+    static constexpr BigFixedInt fromHex(std::string_view str)
+    {
+        constexpr auto exceptionMsg = "BigFixedInt fromHex has invalid argument";
+        const bool strIsNeg = str.substr(0, 3) == "-0x"  ? true
+                              : str.substr(0, 2) == "0x" ? false
+                                                         : throw std::invalid_argument(exceptionMsg);
+        str.remove_prefix(strIsNeg ? 3 : 2);
+        if (str.size() == 0)
+            throw std::invalid_argument(exceptionMsg);
+        BigFixedInt res;
+        for (const auto c : str)
+        {
+            const auto digit = c >= '0' && c <= '9'   ? c - '0'
+                               : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                               : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                                      : throw std::invalid_argument(exceptionMsg);
+            res <<= 4;
+            res.chunks[0] |= static_cast<Chunk>(digit);
+        }
+        if (strIsNeg)
+            res.negate();
+        return res;
+    }
+
+    static constexpr DivModRes divmod(const BigFixedInt &lhs, const BigFixedInt &rhs);
+
+    friend constexpr BigFixedInt operator+(BigFixedInt lhs, const BigFixedInt &rhs) { return lhs += rhs; }
+    friend constexpr BigFixedInt operator-(BigFixedInt lhs, const BigFixedInt &rhs) { return lhs -= rhs; }
+    friend constexpr BigFixedInt operator*(BigFixedInt lhs, const BigFixedInt &rhs) { return lhs *= rhs; }
+    friend constexpr BigFixedInt operator/(const BigFixedInt &lhs, const BigFixedInt &rhs) { return divmod(lhs, rhs).q; }
+    friend constexpr BigFixedInt operator%(const BigFixedInt &lhs, const BigFixedInt &rhs) { return divmod(lhs, rhs).r; }
+    friend constexpr BigFixedInt operator&(BigFixedInt lhs, const BigFixedInt &rhs) { return lhs &= rhs; }
+    friend constexpr BigFixedInt operator|(BigFixedInt lhs, const BigFixedInt &rhs) { return lhs |= rhs; }
+    friend constexpr BigFixedInt operator^(BigFixedInt lhs, const BigFixedInt &rhs) { return lhs ^= rhs; }
+    friend constexpr BigFixedInt operator<<(BigFixedInt lhs, const std::int64_t rhs) { return lhs <<= rhs; }
+    friend constexpr BigFixedInt operator>>(BigFixedInt lhs, const std::int64_t rhs) { return lhs >>= rhs; }
+    friend constexpr bool operator==(const BigFixedInt &lhs, const BigFixedInt &rhs) = default;
+
+    friend constexpr std::strong_ordering operator<=>(const BigFixedInt &lhs, const BigFixedInt &rhs)
+    {
+        if (lhs.isNeg() != rhs.isNeg())
+            return lhs.isNeg() ? std::strong_ordering::less : std::strong_ordering::greater;
+        for (auto i = Size; i--;)
+        {
+            if (lhs.chunks[i] != rhs.chunks[i])
+                return lhs.chunks[i] <=> rhs.chunks[i];
+        }
+        return std::strong_ordering::equal;
+    }
+};
+
+template <std::size_t Bits, bool Signed>
+struct BigFixedInt<Bits, Signed>::DivModRes
+{
+    BigFixedInt q;
+    BigFixedInt r;
+};
+
+template <std::size_t Bits, bool Signed>
+constexpr auto BigFixedInt<Bits, Signed>::divmod(const BigFixedInt &lhs, const BigFixedInt &rhs) -> DivModRes
+{
+    using DoubleChunk = BigIntDoubleChunk;
+    const auto u = lhs.isNeg() ? -lhs : lhs;
+    const auto v = rhs.isNeg() ? -rhs : rhs;
+    auto n = Size;
+    while (n && v.chunks[n - 1] == 0)
+    {
+        --n;
+    }
+    if (n == 0)
+        throw std::invalid_argument("BigFixedInt divmod rhs is zero");
+    DivModRes res;
+    if (n == 1)
+    {
+        DoubleChunk rem = 0;
+        for (auto i = Size; i--;)
+        {
+            rem = rem << ChunkBits | u.chunks[i];
+            res.q.chunks[i] = static_cast<Chunk>(rem / v.chunks[0]);
+            rem %= v.chunks[0];
+        }
+        res.r.chunks[0] = static_cast<Chunk>(rem);
+    }
+    else
+    {
+        // Knuth algorithm D on the operands shifted so the divisor's top bit is set
+        const auto s = std::countl_zero(v.chunks[n - 1]);
+        auto shl = [s](Chunk hi, Chunk lo)
+        { return s ? static_cast<Chunk>(hi << s | lo >> (ChunkBits - s)) : hi; };
+        std::array<Chunk, Size> vn{};
+        std::array<Chunk, Size + 1> un{};
+        for (std::size_t i = n; i--;)
+        {
+            vn[i] = shl(v.chunks[i], i ? v.chunks[i - 1] : 0);
+        }
+        un[Size] = shl(0, u.chunks[Size - 1]);
+        for (std::size_t i = Size; i--;)
+        {
+            un[i] = shl(u.chunks[i], i ? u.chunks[i - 1] : 0);
+        }
+        for (auto j = Size - n + 1; j--;)
+        {
+            const auto uu = static_cast<DoubleChunk>(un[j + n]) << ChunkBits | un[j + n - 1];
+            DoubleChunk qhat = uu / vn[n - 1];
+            DoubleChunk rhat = uu % vn[n - 1];
+            while (qhat >> ChunkBits || qhat * vn[n - 2] > (rhat << ChunkBits | un[j + n - 2]))
+            {
+                --qhat;
+                rhat += vn[n - 1];
+                if (rhat >> ChunkBits)
+                    break;
+            }
+            Chunk carry = 0, borrow = 0;
+            for (std::size_t i = 0; i <= n; ++i)
+            {
+                const auto prod = i < n ? qhat * vn[i] + carry : carry;
+                carry = static_cast<Chunk>(prod >> ChunkBits);
+                const auto x = un[i + j] - static_cast<Chunk>(prod);
+                const Chunk b = un[i + j] < static_cast<Chunk>(prod);
+                un[i + j] = x - borrow;
+                borrow = b | (x < borrow);
+            }
+            if (borrow)
+            {
+                --qhat;
+                carry = 0;
+                for (std::size_t i = 0; i <= n; ++i)
+                {
+                    const Chunk x = un[i + j] + carry;
+                    carry = x < carry;
+                    un[i + j] = x + (i < n ? vn[i] : 0);
+                    carry += un[i + j] < x;
+                }
+            }
+            res.q.chunks[j] = static_cast<Chunk>(qhat);
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            res.r.chunks[i] = s ? static_cast<Chunk>(un[i] >> s | un[i + 1] << (ChunkBits - s)) : un[i];
+        }
+    }
+    if (lhs.isNeg() != rhs.isNeg())
+        res.q.negate();
+    if (lhs.isNeg())
+        res.r.negate();
+    return res;
+}
+
+template <std::size_t Bits>
+using BigUInt = BigFixedInt<Bits, false>;
+template <std::size_t Bits>
+using BigSInt = BigFixedInt<Bits, true>;
+
+// Value of a _big literal. The chunks are computed at compile time, so a
+// constexpr one costs nothing at startup and viewing it doesn't copy.
+template <std::size_t N>
+struct BigIntConst
+{
+    std::array<BigIntChunk, N> chunks{};
+
+    constexpr operator BigIntView() const { return BigIntView(chunks); }
+    operator BigInt() const { return BigInt(BigIntView(*this)); }
+    BigInt operator-() const { return -BigInt(*this); }
+};
+
+// Decimal, 0x hex, 0b binary or 0 octal literal parsed at compile time, like
+// 1'000'000'007_big. The prefixes follow the built in integer literals.
+template <char... Cs>
+consteval auto operator""_big()
+{
+    constexpr std::size_t len = sizeof...(Cs);
+    constexpr auto val = []
+    {
+        constexpr char raw[]{Cs...};
+        std::array<char, len> str{};
+        std::size_t n = 0;
+        for (const auto c : raw)
+        {
+            if (c != '\'')
+                str[n++] = c;
+        }
+        if (n > 1 && (str[1] == 'X' || str[1] == 'B'))
+            str[1] = str[1] == 'X' ? 'x' : 'b';
+        const std::string_view sv(str.data(), n);
+        using Fixed = BigUInt<(len * 4 + 63) / 64 * 64>;
+        if (sv.substr(0, 2) == "0x")
+            return Fixed::fromHex(sv);
+        if (sv.substr(0, 2) != "0b" && (sv.size() == 1 || sv[0] != '0'))
+            return Fixed::fromString(sv);
+        // binary after 0b or octal after a leading 0, the compiler already
+        // rejected digits out of range
+        const auto bits = sv[1] == 'b' ? 1 : 3;
+        Fixed res;
+        for (const auto c : sv.substr(bits == 1 ? 2 : 1))
+        {
+            res <<= bits;
+            res.chunks[0] |= static_cast<BigIntChunk>(c - '0');
+        }
+        return res;
+    }();
+    constexpr auto size = [&]
+    {
+        auto n = val.Size;
+        while (n && val.chunks[n - 1] == 0)
+        {
+            --n;
+        }
+        return n;
+    }();
+    BigIntConst<size> res;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        res.chunks[i] = val.chunks[i];
+    }
+    return res;
+}
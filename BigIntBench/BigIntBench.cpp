@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "BigInt.h"
+
+static std::mt19937_64 rng(42);
+static std::size_t sink = 0;
+
+static BigInt randomBigInt(std::size_t n)
+{
+    BigInt res;
+    res.chunks.resize(n);
+    for (auto &chunk : res.chunks)
+    {
+        chunk = static_cast<BigInt::Chunk>(rng());
+    }
+    res.chunks.back() |= 1;
+    return res;
+}
+
+// runs fn repeatedly for about a quarter second and prints the time per call
+static void bench(std::string_view name, const std::function<void()> &fn)
+{
+    using Clock = std::chrono::steady_clock;
+    std::size_t reps = 0;
+    const auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    while (elapsed < std::chrono::milliseconds(250))
+    {
+        fn();
+        ++reps;
+        elapsed = Clock::now() - start;
+    }
+    const auto ns = std::chrono::duration<double, std::nano>(elapsed).count() / reps;
+    std::cout << std::left << std::setw(48) << name
+              << std::right << std::setw(14) << std::fixed << std::setprecision(1) << ns << " ns\n";
+}
+
+static void benchAlloc()
+{
+    std::vector<std::byte> buffer(64 << 20);
+    auto arena = [&](const std::function<void()> &fn)
+    {
+        return [&buffer, fn]
+        {
+            std::pmr::monotonic_buffer_resource res(buffer.data(), buffer.size());
+            BigIntResourceScope scope(&res);
+            fn();
+        };
+    };
+    for (std::size_t n : {64, 1000, 10000})
+    {
+        const auto x = randomBigInt(n), y = randomBigInt(n);
+        auto fn = [&]
+        { sink += (x * y).chunks.size(); };
+        bench("mul " + std::to_string(n) + " chunks default", fn);
+        bench("mul " + std::to_string(n) + " chunks arena", arena(fn));
+    }
+    const auto base = randomBigInt(4);
+    auto pow = [&]
+    { sink += BigInt::pow(base, 5000).chunks.size(); };
+    bench("pow 128 bits ^ 5000 default", pow);
+    bench("pow 128 bits ^ 5000 arena", arena(pow));
+    std::vector<BigInt> xs;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        xs.push_back(randomBigInt(8));
+    }
+    auto sum = [&]
+    {
+        BigInt acc;
+        for (const auto &x : xs)
+        {
+            acc = acc + x;
+        }
+        sink += acc.chunks.size();
+    };
+    bench("sum 1000 x 8 chunks default", sum);
+    bench("sum 1000 x 8 chunks arena", arena(sum));
+}
+
+static void benchPool()
+{
+    const auto x = randomBigInt(1000), y = randomBigInt(1000);
+    const auto base = randomBigInt(4);
+    const auto d = randomBigInt(40);
+    auto work = [&]
+    {
+        sink += (x * y).chunks.size();
+        sink += BigInt::pow(base, 500).chunks.size();
+        sink += BigInt::divmod(x, d).r.chunks.size();
+    };
+    bench("mul, pow, divmod default", work);
+    BigIntPool::enable();
+    BigIntPool::resetStats();
+    bench("mul, pow, divmod pool", work);
+    const auto stats = BigIntPool::stats();
+    std::cout << "pool hit rate " << stats.hitRate() << " (" << stats.hits << " hits, "
+              << stats.misses << " misses, " << stats.freed << " freed)\n";
+    BigIntPool::disable();
+}
+
+static void benchAddSub()
+{
+    for (std::size_t n : {1, 10, 100, 1000, 10000})
+    {
+        const auto x = randomBigInt(n), y = randomBigInt(n) + randomBigInt(n);
+        const auto name = std::to_string(n) + " chunks";
+        bench("add " + name, [&]
+              { sink += (x + y).chunks.size(); });
+        bench("sub smaller " + name, [&]
+              { sink += (y - x).chunks.size(); });
+        bench("sub larger " + name, [&]
+              { sink += (x - y).chunks.size(); });
+        auto acc = x;
+        bench("add assign " + name, [&]
+              { sink += (acc += x).chunks.size(); });
+    }
+    BigInt ones;
+    ones.chunks.resize(10000);
+    std::fill(ones.chunks.begin(), ones.chunks.end(), static_cast<BigInt::Chunk>(-1));
+    bench("add carry run 10000 chunks", [&]
+          { sink += (ones + ones).chunks.size(); });
+}
+
+static void benchAccumulate()
+{
+    std::vector<BigInt> xs;
+    for (std::size_t i = 0; i < 100000; ++i)
+    {
+        xs.push_back(randomBigInt(16));
+    }
+    bench("sum 100000 x 16 chunks add assign", [&]
+          {
+              BigInt acc;
+              for (const auto &x : xs)
+              {
+                  acc += x;
+              }
+              sink += acc.chunks.size();
+          });
+    bench("sum 100000 x 16 chunks accumulator", [&]
+          {
+              BigIntAccumulator acc;
+              for (const auto &x : xs)
+              {
+                  acc += x;
+              }
+              sink += acc.total().chunks.size();
+          });
+}
+
+static void benchSort()
+{
+    std::vector<BigInt> keys;
+    for (std::size_t i = 0; i < 100000; ++i)
+    {
+        auto key = randomBigInt(1 + rng() % 8);
+        if (rng() % 2)
+            key.negate();
+        keys.push_back(std::move(key));
+    }
+    bench("copy 100000 keys", [&]
+          {
+              auto xs = keys;
+              sink += xs.size();
+          });
+    bench("copy and sort 100000 keys", [&]
+          {
+              auto xs = keys;
+              std::sort(xs.begin(), xs.end());
+              sink += xs.front().chunks.size();
+          });
+}
+
+static void benchMul()
+{
+    for (std::size_t n : {8, 24, 48, 100, 300, 1000, 3000, 6000, 10000, 100000})
+    {
+        const auto x = randomBigInt(n), y = randomBigInt(n);
+        bench("mul " + std::to_string(n) + " x " + std::to_string(n) + " chunks", [&]
+              { sink += (x * y).chunks.size(); });
+        bench("square " + std::to_string(n) + " chunks", [&]
+              { sink += BigInt::square(x).chunks.size(); });
+    }
+    for (std::size_t n : {1000, 100000})
+    {
+        const auto x = randomBigInt(n), y = randomBigInt(n / 10);
+        bench("mul " + std::to_string(n) + " x " + std::to_string(n / 10) + " chunks", [&]
+              { sink += (x * y).chunks.size(); });
+    }
+    const auto huge = randomBigInt(1000000);
+    bench("square 1000000 chunks", [&]
+          { sink += BigInt::square(huge).chunks.size(); });
+    std::cout << "peak memory of 100000 x 100000 chunks: "
+              << BigInt::mulScratchSize(100000, 100000) * sizeof(BigInt::Chunk) << " bytes\n";
+}
+
+static void benchUnbalanced()
+{
+    for (std::size_t bn : {60, 300, 3000})
+    {
+        for (std::size_t ratio : {125, 150, 175, 200, 250, 1000})
+        {
+            const auto an = bn * ratio / 100;
+            const auto x = randomBigInt(an), y = randomBigInt(bn);
+            bench("mul " + std::to_string(an) + " x " + std::to_string(bn) + " chunks", [&]
+                  { sink += (x * y).chunks.size(); });
+        }
+    }
+    const auto x = randomBigInt(1000000), y = randomBigInt(1000);
+    bench("mul 1000000 x 1000 chunks", [&]
+          { sink += (x * y).chunks.size(); });
+}
+
+// the schoolbook product the library used before the row kernels, one
+// rippling carry per chunk product, kept as a baseline for benchBasecase
+static void mulChunkByChunk(BigInt::Chunk *r, const BigInt::Chunk *a, const std::size_t an, const BigInt::Chunk *b, const std::size_t bn)
+{
+    std::fill(r, r + an + bn, 0);
+    for (std::size_t i = 0; i < an; ++i)
+    {
+        for (std::size_t j = 0; j < bn; ++j)
+        {
+            auto x = static_cast<BigIntDoubleChunk>(a[i]) * b[j];
+            for (auto k = i + j; x; ++k)
+            {
+                x += r[k];
+                r[k] = static_cast<BigInt::Chunk>(x);
+                x >>= BigInt::ChunkBits;
+            }
+        }
+    }
+}
+
+static void benchBasecase()
+{
+    for (std::size_t n : {1, 2, 4, 8, 16, 23, 32, 48, 64})
+    {
+        const auto x = randomBigInt(n), y = randomBigInt(n);
+        const auto name = std::to_string(n) + " x " + std::to_string(n) + " chunks ";
+        std::vector<BigInt::Chunk> r(2 * n);
+        bench(name + "chunk by chunk", [&]
+              {
+                  mulChunkByChunk(r.data(), x.chunks.data(), n, y.chunks.data(), n);
+                  sink += r[n];
+              });
+        BigInt dst;
+        bench(name + "mul", [&]
+              {
+                  BigInt::mul(dst, x, y);
+                  sink += dst.chunks.size();
+              });
+        bench(name + "square", [&]
+              {
+                  BigInt::mul(dst, x, x);
+                  sink += dst.chunks.size();
+              });
+    }
+}
+
+template <std::size_t Bits>
+static void benchFixedWidth()
+{
+    const auto x = randomBigInt(Bits / BigInt::ChunkBits), y = randomBigInt(Bits / BigInt::ChunkBits / 2);
+    const BigUInt<Bits> fx(x), fy(y);
+    const auto name = std::to_string(Bits) + " bits ";
+    bench(name + "add BigInt", [&]
+          { sink += (x + y).chunks.size(); });
+    bench(name + "add BigUInt", [&]
+          { sink += static_cast<std::size_t>((fx + fy).chunks[0]); });
+    bench(name + "mul BigInt", [&]
+          { sink += (x * y).chunks.size(); });
+    bench(name + "mul BigUInt", [&]
+          { sink += static_cast<std::size_t>((fx * fy).chunks[0]); });
+    bench(name + "divmod BigInt", [&]
+          { sink += BigInt::divmod(x, y).r.chunks.size(); });
+    bench(name + "divmod BigUInt", [&]
+          { sink += static_cast<std::size_t>(BigUInt<Bits>::divmod(fx, fy).r.chunks[0]); });
+}
+
+static void benchFixed()
+{
+    benchFixedWidth<128>();
+    benchFixedWidth<256>();
+    benchFixedWidth<512>();
+}
+
+int main(int argc, char **argv)
+{
+    const std::vector<std::pair<std::string_view, std::function<void()>>> groups{
+        {"alloc", benchAlloc},
+        {"pool", benchPool},
+        {"fixed", benchFixed},
+        {"addsub", benchAddSub},
+        {"accumulate", benchAccumulate},
+        {"sort", benchSort},
+        {"mul", benchMul},
+        {"unbalanced", benchUnbalanced},
+        {"basecase", benchBasecase},
+    };
+    const std::string_view only = argc > 1 ? argv[1] : "";
+    for (const auto &[name, fn] : groups)
+    {
+        if (only.empty() || only == name)
+        {
+            std::cout << "== " << name << " ==\n";
+            fn();
+        }
+    }
+    if (sink == 0)
+        std::cout << "unexpected sink\n";
+}
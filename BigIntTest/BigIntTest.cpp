@@ -1,8 +1,14 @@
+#include <bit>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <memory_resource>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 #include <gtest/gtest.h>
 #include "BigInt.h"
 
@@ -50,6 +56,225 @@ TEST(BigIntDoubleCtor, Works)
                 big == BigInt(0) /* msvc */);
 }
 
+TEST(BigIntChunkVec, Works)
+{
+    // small values stay in the inline buffer
+    BigInt big(0x1234'5678'9abc'def0);
+    EXPECT_TRUE(big.chunks.capacity() == ChunkVec::InlineCapacity);
+    // growing past the inline capacity goes to the heap and back
+    const auto scale = BigInt::fromHex("0x1" + std::string(BigInt::ChunkBits / 4 * ChunkVec::InlineCapacity, '0'));
+    big *= scale;
+    EXPECT_TRUE(big.chunks.capacity() > ChunkVec::InlineCapacity);
+    EXPECT_TRUE(big == BigInt::fromHex("0x123456789abcdef0" + std::string(BigInt::ChunkBits / 4 * ChunkVec::InlineCapacity, '0')));
+    big /= scale;
+    big.chunks.shrink_to_fit();
+    EXPECT_TRUE(big.chunks.capacity() == ChunkVec::InlineCapacity);
+    EXPECT_TRUE(big == BigInt(0x1234'5678'9abc'def0));
+    // moves between inline and heap storage
+    auto heap = BigInt::fromHex("0x" + std::string(64, 'f'));
+    auto moved = std::move(heap);
+    EXPECT_TRUE(moved == BigInt::fromHex("0x" + std::string(64, 'f')));
+    EXPECT_TRUE(heap.chunks.size() == 0);
+    moved = BigInt(42);
+    EXPECT_TRUE(moved == BigInt(42));
+    heap = std::move(moved);
+    EXPECT_TRUE(heap == BigInt(42));
+    // copies
+    auto copy = big;
+    EXPECT_TRUE(copy == big);
+    copy = BigInt::fromHex("0x" + std::string(64, 'e'));
+    big = copy;
+    EXPECT_TRUE(big == BigInt::fromHex("0x" + std::string(64, 'e')));
+}
+
+TEST(BigIntChunkVec, ChunkBoundariesWork)
+{
+    // results don't depend on the chunk size
+    EXPECT_TRUE(BigInt(0xffff'ffffu).toHex() == "0xffffffff");
+    EXPECT_TRUE(BigInt(0x1'0000'0000u).toHex() == "0x100000000");
+    EXPECT_TRUE(BigInt(0xffff'ffff'ffff'ffffu).toHex() == "0xffffffffffffffff");
+    EXPECT_TRUE((BigInt(0xffff'ffff'ffff'ffffu) + BigInt(1)).toHex() == "0x10000000000000000");
+    EXPECT_TRUE((BigInt(0xffff'ffff'ffff'ffffu) + BigInt(1)).toString() == "18446744073709551616");
+    EXPECT_TRUE(BigInt::fromString("18446744073709551616") == BigInt::fromHex("0x10000000000000000"));
+    EXPECT_TRUE(BigInt::fromHex("0x1000000000000000000000000").toString() == "79228162514264337593543950336");
+    EXPECT_TRUE(BigInt(-0x1'0000'0000).toInteger() == -0x1'0000'0000);
+    EXPECT_TRUE(BigInt(0x1'0000'0000u).toDouble() == 4294967296.0);
+    std::hash<BigInt> h;
+    EXPECT_TRUE(h(BigInt(0x1'0000'0000u)) == h(BigInt::fromHex("0x100000000")));
+}
+
+struct CountingResource : std::pmr::memory_resource
+{
+    std::size_t allocs = 0;
+    std::size_t deallocs = 0;
+    std::size_t allocated = 0;
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        ++allocs;
+        allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t align) override
+    {
+        ++deallocs;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+TEST(BigIntResourceScope, Works)
+{
+    const auto expected = BigInt::pow(BigInt(3), 2000);
+    CountingResource counter;
+    BigInt res;
+    {
+        BigIntResourceScope scope(&counter);
+        auto x = BigInt::pow(BigInt(3), 2000);
+        EXPECT_TRUE(x.chunks.resource() == &counter);
+        EXPECT_TRUE(x == expected);
+        // move assigning to a BigInt from outside the scope copies
+        res = std::move(x);
+        EXPECT_TRUE(res.chunks.resource() == std::pmr::get_default_resource());
+        {
+            // scopes nest
+            std::pmr::monotonic_buffer_resource arena;
+            BigIntResourceScope inner(&arena);
+            EXPECT_TRUE(BigInt().chunks.resource() == &arena);
+            EXPECT_TRUE(BigInt::pow(BigInt(3), 2000) * res == expected * expected);
+        }
+        EXPECT_TRUE(BigInt().chunks.resource() == &counter);
+    }
+    EXPECT_TRUE(counter.allocs > 0);
+    EXPECT_TRUE(counter.allocs == counter.deallocs);
+    EXPECT_TRUE(BigInt().chunks.resource() == std::pmr::get_default_resource());
+    EXPECT_TRUE(res == expected);
+    // move construction keeps the resource
+    {
+        BigIntResourceScope scope(&counter);
+        auto x = expected + BigInt(1);
+        auto y = std::move(x);
+        EXPECT_TRUE(y.chunks.resource() == &counter);
+    }
+    EXPECT_TRUE(counter.allocs == counter.deallocs);
+}
+
+TEST(BigIntPool, Works)
+{
+    const auto x = BigInt::pow(BigInt(7), 3000);
+    const auto expected = x * x;
+    BigIntPool::enable();
+    BigIntPool::resetStats();
+    EXPECT_TRUE(BigIntPool::enabled());
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(x * x == expected);
+    }
+    auto stats = BigIntPool::stats();
+    EXPECT_TRUE(stats.hits > 0);
+    EXPECT_TRUE(stats.cached > 0);
+    EXPECT_TRUE(stats.hitRate() > 0.5);
+    // pooled buffers have power of two capacities
+    auto y = x + BigInt(1);
+    EXPECT_TRUE(std::has_single_bit(y.chunks.capacity()));
+    // buffers can be freed on other threads
+    std::thread([y = std::move(y)] {}).join();
+    // arena buffers are not pooled
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        BigIntResourceScope scope(&arena);
+        BigIntPool::resetStats();
+        EXPECT_TRUE(x * x == expected);
+        stats = BigIntPool::stats();
+        EXPECT_TRUE(stats.hits + stats.misses + stats.cached + stats.freed == 0);
+    }
+    // a cache limit of zero frees everything
+    BigIntPool::enable(0);
+    BigIntPool::release();
+    BigIntPool::resetStats();
+    EXPECT_TRUE(x * x == expected);
+    stats = BigIntPool::stats();
+    EXPECT_TRUE(stats.hits == 0 && stats.cached == 0 && stats.freed > 0);
+    BigIntPool::disable();
+    EXPECT_FALSE(BigIntPool::enabled());
+    BigIntPool::resetStats();
+    EXPECT_TRUE(x * x == expected);
+    stats = BigIntPool::stats();
+    EXPECT_TRUE(stats.hits + stats.misses + stats.cached + stats.freed == 0);
+}
+
+TEST(BigIntChunkVec, ShareWorks)
+{
+    const auto expected = BigInt::pow(BigInt(3), 1000);
+    auto big = expected;
+    big.chunks.share();
+    EXPECT_TRUE(big.chunks.isShared());
+    EXPECT_TRUE(big == expected);
+    // copies share the buffer
+    const auto copy = big;
+    EXPECT_TRUE(copy.chunks.data() == std::as_const(big).chunks.data());
+    EXPECT_TRUE(big.chunks.useCount() == 2);
+    auto assigned = BigInt(42);
+    assigned = copy;
+    EXPECT_TRUE(big.chunks.useCount() == 3);
+    EXPECT_TRUE(assigned == expected);
+    // writing gives a private copy and leaves the others alone
+    big += BigInt(1);
+    EXPECT_TRUE(big == expected + BigInt(1));
+    EXPECT_TRUE(copy == expected);
+    EXPECT_TRUE(assigned == expected);
+    EXPECT_TRUE(copy.chunks.useCount() == 2);
+    EXPECT_TRUE(big.chunks.useCount() == 1);
+    EXPECT_TRUE(big.chunks.isShared());
+    assigned <<= 1;
+    EXPECT_TRUE(assigned == expected * BigInt(2));
+    EXPECT_TRUE(copy.chunks.useCount() == 1);
+    EXPECT_TRUE(copy == expected);
+    // a sole owner writes in place
+    const auto before = std::as_const(big).chunks.data();
+    big -= BigInt(1);
+    EXPECT_TRUE(std::as_const(big).chunks.data() == before);
+    EXPECT_TRUE(big == expected);
+    // moves keep sharing
+    auto moved = std::move(assigned);
+    EXPECT_TRUE(moved.chunks.isShared());
+    auto other = BigInt::pow(BigInt(5), 1000);
+    other = std::move(moved);
+    EXPECT_TRUE(other == expected * BigInt(2));
+    EXPECT_TRUE(other.chunks.isShared());
+    // small values stay inline
+    auto small = BigInt(42);
+    small.chunks.share();
+    auto smallCopy = small;
+    EXPECT_TRUE(smallCopy.chunks.useCount() == 1);
+    smallCopy <<= 1000;
+    EXPECT_TRUE(smallCopy.chunks.isShared());
+    EXPECT_TRUE(smallCopy == BigInt(42) * BigInt::pow(BigInt(2), 1000));
+    // reference count is shared across threads
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&copy, &expected]
+                             {
+                                 for (int j = 0; j < 1000; ++j)
+                                 {
+                                     auto x = copy;
+                                     if (j % 100 == 0)
+                                     {
+                                         EXPECT_TRUE((x += BigInt(1)) == expected + BigInt(1));
+                                     }
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_TRUE(copy.chunks.useCount() == 1);
+    EXPECT_TRUE(copy.toString() == expected.toString());
+}
+
 TEST(BigIntAddOps, AddAssignWorks)
 {
     BigInt acc, other;
@@ -122,6 +347,23 @@ TEST(BigIntAddOps, AddAssignWorks)
     EXPECT_TRUE(acc == BigInt::fromString("2102486884171322324163508745698989955065006512742716529869"));
 }
 
+TEST(BigIntAddOps, LongCarryWorks)
+{
+    const auto ones = BigInt::fromHex("0x" + std::string(1000, 'f'));
+    const auto pow2 = BigInt::fromHex("0x1" + std::string(1000, '0'));
+    EXPECT_TRUE(ones + BigInt(1) == pow2);
+    EXPECT_TRUE(pow2 - BigInt(1) == ones);
+    EXPECT_TRUE(BigInt(1) - pow2 == -ones);
+    EXPECT_TRUE(-ones - BigInt(1) == -pow2);
+    EXPECT_TRUE(ones + ones == pow2 + pow2 - BigInt(2));
+    EXPECT_TRUE(ones - pow2 == BigInt(-1));
+    // operands with different offsets
+    EXPECT_TRUE((BigInt(1) << 64) - (BigInt(3) << 32) == BigInt::fromHex("0xfffffffd00000000"));
+    EXPECT_TRUE((BigInt(3) << 32) - (BigInt(1) << 64) == BigInt::fromHex("-0xfffffffd00000000"));
+    EXPECT_TRUE(BigInt(5) - (BigInt(7) << 128) == BigInt::fromHex("-0x6fffffffffffffffffffffffffffffffb"));
+    EXPECT_TRUE((BigInt(7) << 128) + BigInt(5) - (BigInt(7) << 128) == BigInt(5));
+}
+
 TEST(BigIntAddOps, InfixAddWorks)
 {
     BigInt lhs, rhs;
@@ -341,8 +583,7 @@ TEST(BigIntMulOps, SmallMulWorks)
 
 TEST(BigIntMulOps, Toom2Works)
 {
-    // Toom2Thresh = 550
-    // sqrt(550) = 23.5
+    // Toom2Thresh = 24 chunks
     // both sides are atleast 24 chunks
     auto lhs = BigInt::fromString("166761980331537136226489176884364506000981218102098661939370637060583651707419466989009715150875872382382312905716759787009487499758649115216871159036572164628339139730876537123268757842025850102343104817135557617221139173266017116");
     auto rhs = BigInt::fromString("1397318371973035919656114717900648258628998572794984953703560130027648922196040255992439526541076606985354847569876017788092930508510497284566126564859858329324529733786906743390648011321692480325452398688061186542327675358721177568");
@@ -351,14 +592,318 @@ TEST(BigIntMulOps, Toom2Works)
 
 TEST(BigIntMulOps, Toom3Works)
 {
-    // Toom3Thresh = 2200
-    // sqrt(2200) = 46.9
-    // both sides are atleast 47 chunks
+    // both sides are atleast 47 chunks, so Toom2 splits them in halves that
+    // are past Toom2Thresh again
     auto lhs = BigInt::fromString("361987489559061080742775388504576693138988602661174278193829082591098524753033607963852899673015906822159825119033510270775247071855138469425757586562472497066579507270081426710966368629367830819552403805884325451667530991832764046507748391156461092888229826763433829757332438457023144756726472931356239341675529314246890096023296870739856233585257754199957406095571233229882444815333127362036032980200958077073896802693898486590099292812974877173103459");
     auto rhs = BigInt::fromString("290430068059115962151622120164170255734714690535748812846875362839888416815493430920032564816355585122805109211869416452050701056067668515398757786361456782306110487773490116442984217936213028395285350454465759314711860660073796678738552813607747379020444256623566938561226689854423308537093507265923525879324478217300355344654396067613124351950772986292471505677955516057316088579165996928709031570089465945169928264427849676063748201845465136674824226");
     EXPECT_TRUE(lhs * rhs == BigInt::fromString("105132051229186638428411908836829753946332586584002676809559959825381377811796735582712311229513373409132180930161857292271544718611803024531102459704441980117765395458435682008935872820488623252008358582756641387658721152006644810564804290706473583972929068869025124068420331483875517231560379345700550967305125008454096272656553025578868059534489239977505114254748187734668352063483315124824074440967122125546125355588796450504764070792245721806071829069322183960240696401005615911261260596616999723404145157610428216310008843682854369298480601190343646149575504143754688805267603111099097313814039195620495928467329924055516421776160808659497585815670753673613557180006463109953095362466429202875794389030905220764119610966331043154096825885353358660204224500917696327767557280726641778732641778297011352005368406901034417574194242777980745204105567689847142419993900712971356727531604751290033737597734"));
 }
 
+static BigInt mulTestValue(std::size_t n, std::uint64_t seed)
+{
+    BigInt res;
+    res.chunks.resize(n);
+    for (auto &chunk : res.chunks)
+    {
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+        chunk = static_cast<BigInt::Chunk>(seed >> 17);
+    }
+    res.chunks.back() |= 1;
+    return res;
+}
+
+TEST(BigIntMulOps, SquareWorks)
+{
+    for (const std::size_t n : {1, 2, 3, 7, 23, 24, 25, 60, 95, 96, 97, 200, 500, 1500})
+    {
+        BigInt x;
+        x.chunks.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            x.chunks[i] = static_cast<BigInt::Chunk>(i % 3 ? -1 : i * 0x9e3779b97f4a7c15);
+        }
+        x.normalize();
+        const auto expected = x * (x + BigInt(1)) - x;
+        EXPECT_TRUE(BigInt::square(x) == expected);
+        EXPECT_TRUE(x * x == expected);
+        EXPECT_TRUE(BigInt::square(-x << 40) == expected << 80);
+        auto y = x;
+        y *= y;
+        EXPECT_TRUE(y == expected);
+        EXPECT_TRUE(BigInt::pow(x, 3) == expected * x);
+    }
+    EXPECT_TRUE(BigInt::square(BigInt()) == 0);
+}
+
+TEST(BigIntMulOps, ScratchEngineWorks)
+{
+    // Basecase, Toom2, Toom3, Toom4 and blockwise products against products by
+    // one chunk at a time, which only go through the base case
+    const std::vector<std::size_t> sizes{1, 23, 24, 25, 47, 95, 96, 97, 200, 300, 301, 303, 400, 700};
+    std::uint64_t seed = 1;
+    for (auto an : sizes)
+    {
+        for (auto bn : sizes)
+        {
+            const auto a = mulTestValue(an, seed++);
+            const auto b = -mulTestValue(bn, seed++);
+            BigInt expected;
+            for (std::size_t i = 0; i < b.chunks.size(); ++i)
+            {
+                expected += a * BigInt(static_cast<unsigned long long>(b.chunks[i])) << static_cast<std::int64_t>(i) * BigInt::ChunkBits;
+            }
+            expected.negate();
+            EXPECT_TRUE(a * b == expected);
+        }
+    }
+    // all ones maximizes the carries in evaluation and interpolation
+    for (auto n : {96, 97, 98, 300, 301, 302, 303, 1000, 4001})
+    {
+        const auto ones = (BigInt(1) << n * BigInt::ChunkBits) - BigInt(1);
+        EXPECT_TRUE(ones * ones == (BigInt(1) << 2 * n * BigInt::ChunkBits) - (BigInt(1) << n * BigInt::ChunkBits + 1) + BigInt(1));
+    }
+    const auto x = mulTestValue(5000, 7), y = mulTestValue(3000, 8);
+    const auto prod = x * y;
+    EXPECT_TRUE(prod / y == x);
+    EXPECT_TRUE(prod % x == BigInt(0));
+    // the product allocates its result and one scratch buffer
+    EXPECT_TRUE(BigInt::mulScratchSize(0, 5) == 0);
+    EXPECT_TRUE(BigInt::mulScratchSize(5, 5) == 10);
+    EXPECT_TRUE(BigInt::mulScratchSize(5000, 3000) > 8000);
+    EXPECT_TRUE(BigInt::mulScratchSize(5000, 3000) == BigInt::mulScratchSize(3000, 5000));
+    CountingResource res;
+    {
+        BigIntResourceScope scope(&res);
+        EXPECT_TRUE(x * y == prod);
+    }
+    EXPECT_TRUE(res.allocs == 2);
+    const auto peak = BigInt::mulScratchSize(x.chunks.size(), y.chunks.size()) * sizeof(BigInt::Chunk);
+    EXPECT_TRUE(res.allocated >= peak && res.allocated < peak + 256);
+}
+
+TEST(BigIntMulOps, UnbalancedWorks)
+{
+    // Toom-32, Toom-42 and blockwise products across the ratio boundaries,
+    // against a split in pieces of 16 chunks which each stay in the base case
+    std::uint64_t seed = 11;
+    for (std::size_t bn : {48, 61, 97, 301})
+    {
+        for (auto an : {bn * 5 / 4, bn * 4 / 3, bn * 3 / 2, bn * 7 / 4 - 1, bn * 7 / 4, bn * 2, bn * 3 - 1, bn * 3, bn * 10 + 7})
+        {
+            for (const bool ones : {false, true})
+            {
+                const auto a = ones ? (BigInt(1) << an * BigInt::ChunkBits) - BigInt(1) : mulTestValue(an, seed++);
+                const auto b = ones ? (BigInt(1) << bn * BigInt::ChunkBits) - BigInt(1) : -mulTestValue(bn, seed++);
+                BigInt expected;
+                for (std::size_t i = 0; i < an; i += 16)
+                {
+                    const auto bits = static_cast<std::int64_t>(i) * BigInt::ChunkBits;
+                    expected += ((a >> bits) % (BigInt(1) << 16 * BigInt::ChunkBits)) * b << bits;
+                }
+                EXPECT_TRUE(a * b == expected);
+                EXPECT_TRUE(b * a == expected);
+            }
+        }
+    }
+}
+
+TEST(BigIntMulOps, Toom8Works)
+{
+    // Toom-8 products, down to a top piece of a single chunk, against a split
+    // in pieces of 300 chunks whose products stay in the lower Toom tiers
+    std::uint64_t seed = 17;
+    for (auto [an, bn] : {std::pair<std::size_t, std::size_t>{1300, 1300}, {1301, 1300}, {1600, 1401}, {2000, 1751}, {2047, 2047}, {5999, 5500}})
+    {
+        const auto a = mulTestValue(an, seed++), b = -mulTestValue(bn, seed++);
+        BigInt expected;
+        for (std::size_t i = 0; i < an; i += 300)
+        {
+            const auto bits = static_cast<std::int64_t>(i) * BigInt::ChunkBits;
+            expected += ((a >> bits) % (BigInt(1) << 300 * BigInt::ChunkBits)) * b << bits;
+        }
+        EXPECT_TRUE(a * b == expected);
+        EXPECT_TRUE(b * a == expected);
+        EXPECT_TRUE(BigInt::square(a) == a * (a + BigInt(1)) - a);
+    }
+    // all ones gives the largest evaluations at +-8
+    for (std::size_t n : {1300, 2001, 5999})
+    {
+        const auto ones = (BigInt(1) << n * BigInt::ChunkBits) - BigInt(1);
+        EXPECT_TRUE(ones * ones == (BigInt(1) << 2 * n * BigInt::ChunkBits) - (BigInt(1) << n * BigInt::ChunkBits + 1) + BigInt(1));
+        EXPECT_TRUE(BigInt::square(ones) == ones * (ones + BigInt(1)) - ones);
+    }
+}
+
+TEST(BigIntMulOps, NttMatchesToom)
+{
+    // NTT products against a split in pieces of 1000 chunks, whose products
+    // all stay in the Toom tiers
+    std::uint64_t seed = 23;
+    for (auto [an, bn] : {std::pair<std::size_t, std::size_t>{6000, 6000}, {6001, 6000}, {8192, 8192}, {12000, 7001}, {17999, 6000}})
+    {
+        const auto a = mulTestValue(an, seed++), b = -mulTestValue(bn, seed++);
+        BigInt expected;
+        for (std::size_t i = 0; i < an; i += 1000)
+        {
+            const auto bits = static_cast<std::int64_t>(i) * BigInt::ChunkBits;
+            expected += ((a >> bits) % (BigInt(1) << 1000 * BigInt::ChunkBits)) * b << bits;
+        }
+        EXPECT_TRUE(a * b == expected);
+        EXPECT_TRUE(BigInt::square(b) == b * (b + BigInt(1)) - b);
+    }
+    // all ones gives the largest convolution coefficients
+    for (std::size_t n : {6000, 30000})
+    {
+        const auto ones = (BigInt(1) << n * BigInt::ChunkBits) - BigInt(1);
+        EXPECT_TRUE(ones * ones == (BigInt(1) << 2 * n * BigInt::ChunkBits) - (BigInt(1) << n * BigInt::ChunkBits + 1) + BigInt(1));
+        EXPECT_TRUE(BigInt::square(ones) == ones * (ones + BigInt(1)) - ones);
+    }
+}
+
+TEST(BigIntKernels, AgreeWithPortable)
+{
+    EXPECT_TRUE(BigIntKernels::available(BigIntKernels::Kind::Portable));
+    const auto a = BigInt::pow(BigInt(3), 5000) - BigInt(1);
+    const auto b = BigInt::pow(BigInt(7), 1200) + BigInt(1);
+    const auto allOnes = (BigInt(1) << 4000) - BigInt(1);
+    const auto run = [&]
+    {
+        return std::vector<BigInt>{a + b, a - b, b - a, allOnes + BigInt(1), a * b, allOnes * allOnes, a / b, a % b, allOnes / (b >> 64), allOnes % b};
+    };
+    BigIntKernels::force(BigIntKernels::Kind::Portable);
+    EXPECT_TRUE(BigIntKernels::active() == BigIntKernels::Kind::Portable);
+    const auto expected = run();
+    EXPECT_TRUE(expected[7] + expected[6] * b == a);
+    if (BigIntKernels::available(BigIntKernels::Kind::Adx))
+    {
+        BigIntKernels::force(BigIntKernels::Kind::Adx);
+        EXPECT_TRUE(BigIntKernels::active() == BigIntKernels::Kind::Adx);
+        EXPECT_TRUE(run() == expected);
+    }
+    else
+        EXPECT_THROW(BigIntKernels::force(BigIntKernels::Kind::Adx), std::invalid_argument);
+    BigIntKernels::reset();
+    EXPECT_TRUE(run() == expected);
+}
+
+TEST(BigIntMulOps, AddMulWorks)
+{
+    const auto small = BigInt::pow(BigInt(3), 100), big = BigInt::pow(BigInt(7), 2000);
+    const std::vector<BigInt> vals{BigInt(0), BigInt(1), BigInt(-1), small, -small, small << 70, -small << 33, big, -big};
+    for (const auto &acc : vals)
+    {
+        for (const auto &a : vals)
+        {
+            for (const auto &b : {small, -small << 40, big, BigInt(0)})
+            {
+                EXPECT_TRUE(BigInt(acc).addMul(a, b) == acc + a * b);
+                EXPECT_TRUE(BigInt(acc).subMul(a, b) == acc - a * b);
+            }
+            EXPECT_TRUE(BigInt(acc).addMul(a, 1'000'000'007) == acc + a * BigInt(1'000'000'007));
+            EXPECT_TRUE(BigInt(acc).subMul(a, -3) == acc + a * BigInt(3));
+            EXPECT_TRUE(BigInt(acc).subMul(a, UINT64_MAX) == acc - a * BigInt(UINT64_MAX));
+        }
+    }
+    // the accumulator may be an operand
+    auto x = small;
+    x.addMul(x, x);
+    EXPECT_TRUE(x == small + small * small);
+    x = small;
+    x.subMul(x, small);
+    EXPECT_TRUE(x == small - small * small);
+}
+
+TEST(BigIntMulOps, AddMulDoesNotAllocate)
+{
+    const auto a = BigInt::pow(BigInt(3), 200), b = BigInt::pow(BigInt(5), 100);
+    CountingResource res;
+    {
+        BigIntResourceScope scope(&res);
+        auto acc = BigInt::pow(BigInt(7), 300);
+        acc.chunks.reserve(acc.chunks.size() + a.chunks.size() + b.chunks.size() + 4);
+        res.allocs = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            acc.addMul(a, b);
+            acc.subMul(a, 12345);
+        }
+        EXPECT_TRUE(res.allocs == 0);
+    }
+}
+
+TEST(BigIntMulOps, DestinationApiWorks)
+{
+    const auto a = BigInt::pow(BigInt(3), 700), b = -BigInt::pow(BigInt(5), 200) << 40, big = BigInt::pow(BigInt(7), 3000);
+    BigInt dst, q, r;
+    BigInt::add(dst, a, b);
+    EXPECT_TRUE(dst == a + b);
+    BigInt::sub(dst, a, b);
+    EXPECT_TRUE(dst == a - b);
+    BigInt::mul(dst, a, b);
+    EXPECT_TRUE(dst == a * b);
+    BigInt::divmod(q, r, a, b);
+    EXPECT_TRUE(q == a / b && r == a % b);
+    BigInt::shiftLeft(dst, b, 77);
+    EXPECT_TRUE(dst == b << 77);
+    BigInt::shiftRight(dst, b, 77);
+    EXPECT_TRUE(dst == b >> 77);
+    EXPECT_THROW(BigInt::divmod(q, q, a, b), std::invalid_argument);
+    // aliasing
+    for (const auto &y : {b, big})
+    {
+        auto x = a;
+        BigInt::add(x, x, y);
+        EXPECT_TRUE(x == a + y);
+        x = a;
+        BigInt::sub(x, y, x);
+        EXPECT_TRUE(x == y - a);
+        x = a;
+        BigInt::mul(x, x, y);
+        EXPECT_TRUE(x == a * y);
+        x = a;
+        BigInt::mul(x, y, x);
+        EXPECT_TRUE(x == y * a);
+        x = y;
+        BigInt::mul(x, x, x);
+        EXPECT_TRUE(x == y * y);
+        x = big;
+        BigInt::divmod(x, r, x, y);
+        EXPECT_TRUE(x == big / y && r == big % y);
+        x = big;
+        BigInt::divmod(q, x, x, y);
+        EXPECT_TRUE(q == big / y && x == big % y);
+    }
+    // rvalue multiplication
+    EXPECT_TRUE(BigInt(a) * b == a * b);
+    EXPECT_TRUE(a * BigInt(b) == a * b);
+    EXPECT_TRUE(BigInt(a) * BigInt(big) == a * big);
+    auto x = big;
+    x *= std::move(x);
+    EXPECT_TRUE(x == big * big);
+}
+
+TEST(BigIntMulOps, DestinationApiDoesNotAllocate)
+{
+    const auto a = BigInt::pow(BigInt(3), 300), b = BigInt::pow(BigInt(5), 100);
+    CountingResource res;
+    {
+        BigIntResourceScope scope(&res);
+        BigInt dst, acc = a;
+        acc.chunks.reserve(4 * a.chunks.size());
+        BigInt::mul(dst, a, b);
+        res.allocs = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            BigInt::mul(dst, a, b);
+            BigInt::add(dst, dst, a);
+            BigInt::shiftRight(dst, dst, 3);
+            acc = std::move(acc) * b;
+            acc >>= 232;
+        }
+        EXPECT_TRUE(res.allocs == 0);
+    }
+}
+
 TEST(BigIntDivModOps, Works)
 {
     BigInt lhs, rhs;
@@ -496,6 +1041,33 @@ TEST(BigIntBitwiseOps, NotWorks)
     EXPECT_TRUE(~BigInt::fromString("-167204101244213050886353478213410021758") == BigInt::fromString("167204101244213050886353478213410021757"));
 }
 
+TEST(BigIntBitwiseOps, KeepsOffsets)
+{
+    // values shifted by whole chunks keep their low zero chunks as an offset
+    // through the bitwise ops, the result is zero below the lower offset
+    const auto a = BigInt::pow(BigInt(3), 300), b = BigInt::pow(BigInt(7), 150);
+    const std::int64_t k = 8 * BigInt::ChunkBits;
+    for (const auto &x : {a, -a})
+    {
+        for (const auto &y : {b, -b})
+        {
+            const auto xs = x << k, ys = y << 2 * k;
+            EXPECT_TRUE((xs & ys) == (x & (y << k)) << k);
+            EXPECT_TRUE((xs | ys) == (x | (y << k)) << k);
+            EXPECT_TRUE((xs ^ ys) == (x ^ (y << k)) << k);
+            for (const auto &res : {xs & ys, xs | ys, xs ^ ys})
+            {
+                EXPECT_TRUE(res.offset >= 8 || res == 0);
+            }
+        }
+        EXPECT_TRUE(~(x << k) == -(x << k) - BigInt(1));
+        auto flipped = x << k;
+        flipped.flipBit(k + 3 * BigInt::ChunkBits + 5);
+        EXPECT_TRUE(flipped == ((x << k) ^ (BigInt(1) << k + 3 * BigInt::ChunkBits + 5)));
+        EXPECT_TRUE(flipped.offset == 8);
+    }
+}
+
 TEST(BigIntBitwiseOps, InfixWorks)
 {
     BigInt big1, big2;
@@ -543,6 +1115,64 @@ TEST(BigIntBitwiseOps, InfixWorks)
     EXPECT_TRUE((BigInt::fromString("293870858589525163351437814436088209513") ^ BigInt(3466997980255505477)) == BigInt::fromString("293870858589525163354893553391169907756"));
 }
 
+TEST(BigIntBitwiseOps, IdentitiesWork)
+{
+    const auto big = BigInt::pow(BigInt(3), 400);
+    const auto mask = (BigInt(1) << 500) - BigInt(1);
+    std::vector<BigInt> vals{BigInt(0), BigInt(1), BigInt(-1), BigInt(-4294967296), big, -big, mask, -mask, big << 96, -big << 64, -(BigInt(1) << 320)};
+    for (const auto &a : vals)
+    {
+        for (const auto &b : vals)
+        {
+            const auto andRes = a & b, orRes = a | b, xorRes = a ^ b;
+            EXPECT_TRUE(andRes == ~(~a | ~b));
+            EXPECT_TRUE(orRes == ~(~a & ~b));
+            EXPECT_TRUE(andRes + orRes == a + b);
+            EXPECT_TRUE(xorRes == orRes - andRes);
+            EXPECT_TRUE(((a << 70) & (b << 70)) == andRes << 70);
+            EXPECT_TRUE(((a << 70) ^ (b << 70)) == xorRes << 70);
+        }
+    }
+}
+
+TEST(BigIntBitQuery, Works)
+{
+    EXPECT_TRUE(BigInt().bitLength() == 0 && BigInt().popcount() == 0 && BigInt().countTrailingZeros() == 0);
+    const auto big = BigInt::pow(BigInt(3), 200);
+    const auto big2 = (big << 100) + BigInt(1);
+    EXPECT_TRUE(big.bitLength() == 317);
+    EXPECT_TRUE((big << 64).bitLength() == 381 && (-big).bitLength() == 317);
+    EXPECT_TRUE(BigInt(0xff00).popcount() == 8 && BigInt(-0xff00).popcount() == 8);
+    EXPECT_TRUE((big << 100).popcount() == big.popcount());
+    EXPECT_TRUE((big << 100).countTrailingZeros() == 100 && (-big << 70).countTrailingZeros() == 70);
+    EXPECT_TRUE(BigInt(12).countTrailingZeros() == 2);
+    for (const auto &x : {BigInt(0), BigInt(-1), BigInt(5), BigInt(-6), big, -big, big2, -big2, -big << 64})
+    {
+        for (const std::int64_t i : {0, 1, 2, 31, 32, 33, 63, 64, 100, 101, 316, 317, 500})
+        {
+            const auto bit = BigInt(1) << i;
+            EXPECT_TRUE(x.testBit(i) == static_cast<bool>(x & bit));
+            EXPECT_TRUE(BigInt(x).setBit(i) == (x | bit));
+            EXPECT_TRUE(BigInt(x).clearBit(i) == (x & ~bit));
+            EXPECT_TRUE(BigInt(x).flipBit(i) == (x ^ bit));
+        }
+    }
+    EXPECT_THROW(big.testBit(-1), std::invalid_argument);
+    EXPECT_THROW(BigInt(big).setBit(-1), std::invalid_argument);
+}
+
+TEST(BigIntBitQuery, ReadsDoNotAllocate)
+{
+    const auto big = -BigInt::pow(BigInt(3), 1000) << 200;
+    CountingResource res;
+    {
+        BigIntResourceScope scope(&res);
+        EXPECT_TRUE(big.bitLength() > 0 && big.popcount() > 0 && big.countTrailingZeros() == 200);
+        EXPECT_TRUE(big.testBit(200) && !big.testBit(199));
+        EXPECT_TRUE(res.allocs == 0);
+    }
+}
+
 TEST(BigIntShiftOps, AssignWorks)
 {
     BigInt big;
@@ -612,6 +1242,55 @@ TEST(BigIntShiftOps, InfixWorks)
     EXPECT_TRUE(BigInt::fromString("272044912937764710902171231292648911299") >> 89 == BigInt::fromString("439512261183"));
 }
 
+TEST(BigIntShiftOps, OffsetWorks)
+{
+    // whole chunk shifts only move the offset
+    const auto big = BigInt(0x1234'5678) << 1'000'000;
+    EXPECT_TRUE(big.chunks.size() <= 2);
+    auto flat = big;
+    flat.flatten();
+    EXPECT_TRUE(flat.offset == 0);
+    EXPECT_TRUE(flat.chunks.size() > 1000);
+    EXPECT_TRUE(flat == big);
+    EXPECT_TRUE((flat <=> big) == 0);
+    EXPECT_TRUE(std::hash<BigInt>{}(flat) == std::hash<BigInt>{}(big));
+    EXPECT_TRUE(big >> 1'000'000 == BigInt(0x1234'5678));
+    EXPECT_TRUE(-big >> 1'000'003 == BigInt(-0x246'8acf));
+    EXPECT_TRUE(-big >> 1'000'004 == BigInt(-0x123'4568));
+    EXPECT_TRUE(-(BigInt(5) << 64) >> 65 == BigInt(-3));
+    EXPECT_TRUE(-(BigInt(1) << 64) >> 100 == BigInt(-1));
+    // arithmetic
+    EXPECT_TRUE(big + BigInt(1) - big == BigInt(1));
+    EXPECT_TRUE(big - (big + BigInt(1)) == BigInt(-1));
+    EXPECT_TRUE(big * big == BigInt(0x1234'5678) * BigInt(0x1234'5678) << 2'000'000);
+    EXPECT_TRUE((big * BigInt(3)).chunks.size() <= 2);
+    EXPECT_TRUE((big + BigInt(5)) % big == BigInt(5));
+    EXPECT_TRUE(big / BigInt(0x1234'5678) == BigInt(1) << 1'000'000);
+    EXPECT_TRUE(((BigInt(-1) << 64) & (BigInt(0xff) << 60)) == BigInt(0xf0) << 60);
+    EXPECT_TRUE(~(BigInt(1) << 64) == -(BigInt(1) << 64) - BigInt(1));
+    EXPECT_TRUE((BigInt(1) << 64) > BigInt(0xffff'ffff'ffff'ffffu));
+    // conversions
+    EXPECT_TRUE((BigInt(1) << 64).toHex() == "0x10000000000000000");
+    EXPECT_TRUE((BigInt(1) << 64).toString() == "18446744073709551616");
+    EXPECT_TRUE((BigInt(-3) << 32).toInteger() == -0x3'0000'0000);
+    EXPECT_TRUE((BigInt(1) << 64).toDouble() == 18446744073709551616.0);
+}
+
+TEST(BigIntShiftOps, RoundsTowardNegInfWorks)
+{
+    const auto big = BigInt::pow(BigInt(3), 300);
+    for (const auto &x : {big, -big, big << 64, -big << 64, -big << 37, -(BigInt(1) << 200), BigInt(-1), BigInt(-5)})
+    {
+        for (const std::int64_t k : {1, 5, 31, 32, 33, 63, 64, 65, 100, 128, 200, 250, 600})
+        {
+            const auto pow2 = BigInt(1) << k;
+            const auto expected = (x - (x & (pow2 - BigInt(1)))) / pow2;
+            EXPECT_TRUE((x >> k) == expected);
+            EXPECT_TRUE(((x << k) >> k) == x);
+        }
+    }
+}
+
 TEST(BigIntCmpOps, BoolWorks)
 {
     EXPECT_FALSE(BigInt(0));
@@ -665,6 +1344,246 @@ TEST(BigIntCmpOps, CmpWorks)
     EXPECT_TRUE(BigInt::fromString("88807723886191649185632380861854384327") < BigInt::fromString("138670621298285178317743514700496725835"));
 }
 
+TEST(BigIntCmpOps, CmpDoesNotAllocate)
+{
+    const auto big = BigInt::pow(BigInt(3), 1000);
+    const auto neg = -big;
+    const auto shifted = big << 64;
+    const auto negShifted = -shifted;
+    CountingResource res;
+    {
+        BigIntResourceScope scope(&res);
+        EXPECT_TRUE(big < big + BigInt(1));
+        EXPECT_TRUE(big - BigInt(1) < big);
+        EXPECT_TRUE(neg < big);
+        EXPECT_TRUE(neg < BigInt(0));
+        EXPECT_TRUE(BigInt(0) < big);
+        EXPECT_TRUE((big <=> big) == 0);
+        res.allocs = 0;
+        EXPECT_TRUE(big < shifted);
+        EXPECT_TRUE(negShifted < neg);
+        EXPECT_TRUE(neg > negShifted);
+        EXPECT_TRUE(big >= big);
+        EXPECT_TRUE((neg <=> neg) == 0);
+        EXPECT_TRUE(res.allocs == 0);
+    }
+}
+
+template <typename T>
+static void nativeMatchesBigInt(const BigInt &x, const T num)
+{
+    const BigInt big(num);
+    EXPECT_TRUE(x + num == x + big);
+    EXPECT_TRUE(num + x == big + x);
+    EXPECT_TRUE(x - num == x - big);
+    EXPECT_TRUE(num - x == big - x);
+    EXPECT_TRUE(x * num == x * big);
+    EXPECT_TRUE(num * x == big * x);
+    EXPECT_TRUE((x == num) == (x == big));
+    EXPECT_TRUE((x <=> num) == (x <=> big));
+    EXPECT_TRUE((num <=> x) == (big <=> x));
+    if (num != 0)
+    {
+        EXPECT_TRUE(x / num == x / big);
+        EXPECT_TRUE(x % num == x % big);
+    }
+    auto y = x;
+    y += num;
+    y *= num;
+    y -= num;
+    auto z = x;
+    z += big;
+    z *= big;
+    z -= big;
+    EXPECT_TRUE(y == z);
+}
+
+TEST(BigIntNativeOps, Works)
+{
+    const auto big = BigInt::pow(BigInt(3), 300);
+    for (const auto &x : {BigInt(0), BigInt(1), BigInt(-7), BigInt(0xffff'ffffu), big, -big, big << 100, -big << 33})
+    {
+        nativeMatchesBigInt(x, 0);
+        nativeMatchesBigInt(x, 3);
+        nativeMatchesBigInt(x, -7);
+        nativeMatchesBigInt(x, 'a');
+        nativeMatchesBigInt(x, std::uint8_t{200});
+        nativeMatchesBigInt(x, 0xffff'ffffu);
+        nativeMatchesBigInt(x, INT64_MIN);
+        nativeMatchesBigInt(x, INT64_MAX);
+        nativeMatchesBigInt(x, UINT64_MAX);
+    }
+    EXPECT_TRUE(BigInt(-7) / 2 == -3);
+    EXPECT_TRUE(BigInt(-7) % 2 == -1);
+    EXPECT_TRUE(BigInt(7) % -2 == 1);
+    EXPECT_TRUE(-big % 3 == 0);
+    EXPECT_TRUE(0 < big && -big < 0 && BigInt(5) == 5u);
+    auto x = big;
+    x %= 1'000'000'007;
+    EXPECT_TRUE(x == big % BigInt(1'000'000'007));
+    x /= -1;
+    EXPECT_TRUE(x == -(big % BigInt(1'000'000'007)));
+    EXPECT_THROW(big / 0, std::invalid_argument);
+    EXPECT_THROW(big % 0u, std::invalid_argument);
+}
+
+TEST(BigIntNativeOps, DoesNotAllocate)
+{
+    const auto big = BigInt::pow(BigInt(3), 1000);
+    CountingResource res;
+    {
+        BigIntResourceScope scope(&res);
+        std::size_t n = 0;
+        for (BigInt i = 0; i < 1000; ++i)
+        {
+            ++n;
+        }
+        for (BigInt i = 1000; i != 0; i -= 1)
+        {
+            --n;
+        }
+        EXPECT_TRUE(n == 0);
+        EXPECT_TRUE(big % 7 == 4);
+        EXPECT_TRUE(big % 1'000'000'007 != 0);
+        EXPECT_TRUE(big > 0 && big != -1 && big >= INT64_MAX);
+        auto x = big;
+        const auto negBig = -big;
+        res.allocs = 0;
+        x += 12345;
+        x -= 12345;
+        x *= 2;
+        x /= 2;
+        ++x;
+        --x;
+        x.negate();
+        EXPECT_TRUE(x == negBig);
+        EXPECT_TRUE(res.allocs == 0);
+    }
+}
+
+TEST(BigIntAccumulator, Works)
+{
+    EXPECT_TRUE(BigIntAccumulator().total() == 0);
+    std::vector<BigInt> vals;
+    auto x = BigInt::pow(BigInt(3), 150);
+    for (int i = 0; i < 300; ++i)
+    {
+        x = x * BigInt(7) % BigInt::pow(BigInt(2), 500) + BigInt(i);
+        vals.push_back(i % 3 == 0 ? -x : i % 7 == 0 ? x << 200 : x >> (i % 90));
+    }
+    vals.push_back((BigInt(1) << 640) - BigInt(1));
+    BigInt expected;
+    BigIntAccumulator acc, even, odd;
+    for (std::size_t i = 0; i < vals.size(); ++i)
+    {
+        if (i % 5 == 0)
+        {
+            expected -= vals[i];
+            acc -= vals[i];
+            (i % 2 ? odd : even) -= vals[i];
+        }
+        else
+        {
+            expected += vals[i];
+            acc += vals[i];
+            (i % 2 ? odd : even) += vals[i];
+        }
+    }
+    EXPECT_TRUE(acc.total() == expected);
+    EXPECT_TRUE(even.merge(odd).total() == expected);
+    acc.clear();
+    EXPECT_TRUE(acc.total() == 0);
+    acc += BigInt(5);
+    acc -= BigInt(7);
+    EXPECT_TRUE(acc.total() == -2);
+}
+
+TEST(BigIntView, Works)
+{
+    const auto big = BigInt::fromHex("-0x" + std::string(BigInt::ChunkBits / 4, '3') + std::string(BigInt::ChunkBits / 4, '0') + std::string(BigInt::ChunkBits / 4, '1'));
+    const BigIntView view(big);
+    EXPECT_TRUE(view.chunks.data() == big.chunks.data());
+    EXPECT_TRUE(view == big);
+    EXPECT_TRUE(BigInt(view) == big);
+    // slices are normalized and keep the sign
+    EXPECT_TRUE(view.slice(0, 1) == -BigInt::fromHex("0x" + std::string(BigInt::ChunkBits / 4, '1')));
+    EXPECT_TRUE(view.slice(1, 1).chunks.size() == 0);
+    EXPECT_FALSE(view.slice(1, 1).isNeg);
+    EXPECT_TRUE(view.slice(1, 2) == -BigInt::fromHex("0x" + std::string(BigInt::ChunkBits / 4, '3') + std::string(BigInt::ChunkBits / 4, '0')));
+    EXPECT_TRUE(view.slice(2, 42) == -BigInt::fromHex("0x" + std::string(BigInt::ChunkBits / 4, '3')));
+    EXPECT_TRUE(view.slice(42, 1) == BigInt(0));
+    // comparison
+    EXPECT_TRUE(view < view.slice(0, 1));
+    EXPECT_TRUE(view.slice(0, 1) > view);
+    EXPECT_TRUE(BigIntView(BigInt(1)) > BigIntView(BigInt(-2)));
+    EXPECT_TRUE(BigIntView(BigInt(-1)) > BigIntView(BigInt(-2)));
+    EXPECT_TRUE(BigIntView(BigInt(2)) > BigIntView(BigInt(1)));
+    EXPECT_TRUE(BigIntView(BigInt(1)) < BigIntView(BigInt(0x1'0000'0000'0000)));
+    EXPECT_TRUE(BigIntView(BigInt(-1)) > BigIntView(BigInt(-0x1'0000'0000'0000)));
+    EXPECT_TRUE((view <=> big) == 0);
+    // hashing matches the owning value
+    EXPECT_TRUE(std::hash<BigIntView>{}(view) == std::hash<BigInt>{}(big));
+    EXPECT_TRUE(std::hash<BigIntView>{}(view.slice(2, 1)) == std::hash<BigInt>{}(-BigInt::fromHex("0x" + std::string(BigInt::ChunkBits / 4, '3'))));
+}
+
+TEST(BigIntView, OperandsWork)
+{
+    const auto x = -mulTestValue(3000, 31);
+    const BigIntView xv(x);
+    const auto lo = xv.slice(0, 1000), hi = xv.slice(1000, 2000);
+    const auto bits = static_cast<std::int64_t>(1000 * BigInt::ChunkBits);
+    const auto loVal = -(-x % (BigInt(1) << bits)), hiVal = -((-x >> bits) % (BigInt(1) << 2 * bits));
+    EXPECT_TRUE(lo == loVal && hi == hiVal);
+    BigInt res;
+    BigInt::mul(res, lo, hi);
+    EXPECT_TRUE(res == loVal * hiVal);
+    BigInt::add(res, lo, hi);
+    EXPECT_TRUE(res == loVal + hiVal);
+    BigInt::sub(res, lo, hi);
+    EXPECT_TRUE(res == loVal - hiVal);
+    BigInt q, r;
+    BigInt::divmod(q, r, hi, lo);
+    EXPECT_TRUE(q == hiVal / loVal && r == hiVal % loVal);
+    res = 7;
+    res.addMul(lo, hi);
+    EXPECT_TRUE(res == loVal * hiVal + BigInt(7));
+    res.subMul(hi, lo);
+    res.addMul(hi, 3);
+    EXPECT_TRUE(res == hiVal * BigInt(3) + BigInt(7));
+    EXPECT_TRUE(hi.bitLength() == hiVal.bitLength());
+    EXPECT_TRUE(hi.popcount() == hiVal.popcount());
+    EXPECT_TRUE(hi.countTrailingZeros() == hiVal.countTrailingZeros());
+    for (const auto i : std::initializer_list<std::int64_t>{0, 1, 100, 5000, 2 * bits - 1, 2 * bits})
+    {
+        EXPECT_TRUE(hi.testBit(i) == hiVal.testBit(i));
+    }
+    // slices of the destination itself
+    auto y = x;
+    BigInt::mul(y, BigIntView(y).slice(0, 1000), BigIntView(y).slice(1000, 2000));
+    EXPECT_TRUE(y == loVal * hiVal);
+    y = x;
+    BigInt::add(y, BigIntView(y).slice(1000, 2000), y);
+    EXPECT_TRUE(y == hiVal + x);
+    y = x;
+    BigInt::sub(y, y, BigIntView(y).slice(0, 1000));
+    EXPECT_TRUE(y == x - loVal);
+    // small slices neither allocate nor get copied
+    res = loVal * hiVal;
+    res.chunks.reserve(res.chunks.size() + 64);
+    auto sum = loVal;
+    const auto expected = res + BigInt(xv.slice(0, 20)) * BigInt(xv.slice(20, 20)) - BigInt(xv.slice(40, 20)) * BigInt(5);
+    CountingResource counter;
+    {
+        BigIntResourceScope scope(&counter);
+        res.addMul(xv.slice(0, 20), xv.slice(20, 20));
+        res.subMul(xv.slice(40, 20), 5);
+        BigInt::add(sum, xv.slice(0, 20), xv.slice(20, 20));
+    }
+    EXPECT_TRUE(counter.allocs == 0);
+    EXPECT_TRUE(res == expected);
+    EXPECT_TRUE(sum == BigInt(xv.slice(0, 20)) + BigInt(xv.slice(20, 20)));
+}
+
 TEST(BigIntToInteger, Works)
 {
     EXPECT_TRUE(BigInt(42).toInteger() == 42);
@@ -821,3 +1740,129 @@ TEST(BigInt, IsHashable)
     EXPECT_TRUE(xs.contains(BigInt::fromHex(bigStr1)));
     EXPECT_TRUE(xs.contains(BigInt::fromHex(bigStr2)));
 }
+
+template <std::size_t Bits, bool Signed>
+static BigInt fixedWrap(const BigInt &x)
+{
+    const auto mod = BigInt(1) << Bits;
+    auto res = x & (mod - BigInt(1));
+    if (Signed && res >= mod / BigInt(2))
+        res -= mod;
+    return res;
+}
+
+template <std::size_t Bits, bool Signed>
+static void fixedMatchesBigInt()
+{
+    using Fixed = BigFixedInt<Bits, Signed>;
+    auto wrap = [](const BigInt &x)
+    { return fixedWrap<Bits, Signed>(x); };
+    const auto mod = BigInt(1) << Bits;
+    std::vector<BigInt> xs{BigInt(0), BigInt(1), BigInt(-1), BigInt(7), BigInt(-0x1'2345'6789),
+                           mod / BigInt(2), mod / BigInt(2) - BigInt(1), mod - BigInt(1),
+                           BigInt::pow(BigInt(3), Bits / 3), -BigInt::pow(BigInt(7), Bits / 5),
+                           BigInt::pow(BigInt(5), Bits / 4) << Bits / 3, (BigInt(0xffff'ffffu) << Bits / 2) + BigInt(3)};
+    for (auto &x : xs)
+    {
+        x = wrap(x);
+        EXPECT_TRUE(BigInt(Fixed(x)) == x);
+    }
+    for (const auto &x : xs)
+    {
+        const Fixed a(x);
+        EXPECT_TRUE(BigInt(-a) == wrap(-x));
+        EXPECT_TRUE(BigInt(~a) == wrap(~x));
+        EXPECT_TRUE(BigInt(a << 67) == wrap(x << 67));
+        EXPECT_TRUE(BigInt(a >> 67) == x >> 67);
+        EXPECT_TRUE(BigInt(a >> Bits) == x >> Bits);
+        for (const auto &y : xs)
+        {
+            const Fixed b(y);
+            EXPECT_TRUE(BigInt(a + b) == wrap(x + y));
+            EXPECT_TRUE(BigInt(a - b) == wrap(x - y));
+            EXPECT_TRUE(BigInt(a * b) == wrap(x * y));
+            EXPECT_TRUE(BigInt(a & b) == wrap(x & y));
+            EXPECT_TRUE(BigInt(a | b) == wrap(x | y));
+            EXPECT_TRUE(BigInt(a ^ b) == wrap(x ^ y));
+            EXPECT_TRUE((a <=> b) == (x <=> y));
+            EXPECT_TRUE((a == b) == (x == y));
+            if (y)
+            {
+                EXPECT_TRUE(BigInt(a / b) == wrap(x / y));
+                EXPECT_TRUE(BigInt(a % b) == x % y);
+            }
+        }
+    }
+}
+
+TEST(BigUInt, Works)
+{
+    fixedMatchesBigInt<64, false>();
+    fixedMatchesBigInt<128, false>();
+    fixedMatchesBigInt<256, false>();
+    fixedMatchesBigInt<512, false>();
+    // wraps around
+    BigUInt<128> x = -1;
+    EXPECT_TRUE(BigInt(x) == BigInt::fromHex("0x" + std::string(32, 'f')));
+    EXPECT_TRUE(++x == 0);
+    EXPECT_TRUE(x-- == 0);
+    EXPECT_TRUE(x > 1);
+    EXPECT_TRUE(BigUInt<128>(BigInt(-2)) == x - 1);
+    EXPECT_FALSE(BigUInt<256>());
+    EXPECT_THROW(x / 0, std::invalid_argument);
+    EXPECT_THROW(x << -1, std::invalid_argument);
+    static_assert(BigUInt<256>(1) << 200 > BigUInt<256>(1) << 199);
+    static_assert((BigUInt<256>(7) << 130) / (BigUInt<256>(1) << 129) == 14);
+}
+
+TEST(BigSInt, Works)
+{
+    fixedMatchesBigInt<64, true>();
+    fixedMatchesBigInt<128, true>();
+    fixedMatchesBigInt<256, true>();
+    fixedMatchesBigInt<512, true>();
+    BigSInt<128> x = -5;
+    EXPECT_TRUE(x < 0);
+    EXPECT_TRUE(x / 2 == -2);
+    EXPECT_TRUE(x % 2 == -1);
+    EXPECT_TRUE(x >> 1 == -3);
+    EXPECT_TRUE(BigInt(x) == BigInt(-5));
+    const auto min = BigSInt<128>(1) << 127;
+    EXPECT_TRUE(min < 0);
+    EXPECT_TRUE(min - 1 > 0);
+    EXPECT_TRUE(min / -1 == min);
+    static_assert(BigSInt<256>(-3) * BigSInt<256>(-4) == 12);
+}
+
+TEST(BigIntLiteral, Works)
+{
+    static_assert((0_big).chunks.size() == 0);
+    static_assert((0xffff'ffff_big).chunks.size() == 1);
+    static_assert((0x1'0000'0000'0000'0000_big).chunks.size() == 64 / BigInt::ChunkBits + 1);
+    EXPECT_TRUE(BigInt(0_big) == BigInt(0));
+    EXPECT_TRUE(BigInt(42_big) == BigInt(42));
+    EXPECT_TRUE(BigInt(123456789012345678901234567890_big) == BigInt::fromString("123456789012345678901234567890"));
+    EXPECT_TRUE(BigInt(0xDEADbeef'00000000'12345678_big) == BigInt::fromHex("0xdeadbeef0000000012345678"));
+    EXPECT_TRUE(-7_big == BigInt(-7));
+    // every prefix reads like the built in literal
+    EXPECT_TRUE(BigInt(0XFF_big) == BigInt(0XFF));
+    EXPECT_TRUE(BigInt(017_big) == BigInt(017));
+    EXPECT_TRUE(BigInt(00_big) == BigInt(0));
+    EXPECT_TRUE(BigInt(0b1011_big) == BigInt(0b1011));
+    EXPECT_TRUE(BigInt(0B1'0000_big) == BigInt(0B1'0000));
+    EXPECT_TRUE(BigInt(0777'7777'7777'7777'7777'7777'7777_big) == (BigInt(1) << 81) - BigInt(1));
+    EXPECT_TRUE(BigInt(0b1'00000000'00000000'00000000'00000000'00000000'00000000'00000000'00000000_big) == BigInt(1) << 64);
+    // converts implicitly and views without copying
+    static constexpr auto big = 340282366920938463463374607431768211457_big;
+    const BigInt x = big;
+    EXPECT_TRUE(x == BigInt::fromHex("0x100000000000000000000000000000001"));
+    const BigIntView view = big;
+    EXPECT_TRUE(view.chunks.data() == big.chunks.data());
+    EXPECT_TRUE(view == x);
+    EXPECT_TRUE(x * 3_big == BigInt(3) * x);
+    // fixed width parsing is constexpr too
+    static_assert(BigUInt<128>::fromString("340282366920938463463374607431768211455") == -1);
+    static_assert(BigSInt<128>::fromHex("-0x10") == -16);
+    EXPECT_THROW(BigUInt<128>::fromString("12a"), std::invalid_argument);
+    EXPECT_THROW(BigUInt<128>::fromHex("ff"), std::invalid_argument);
+}